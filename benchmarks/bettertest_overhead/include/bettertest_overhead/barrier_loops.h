@@ -0,0 +1,27 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+
+/*
+ * Loops whose only side effects are optimizer barriers. They are compiled at -O3 in a separate file, so that the
+ * barriers are checked against the most aggressive optimization level regardless of the build type.
+ */
+
+/**
+ * \brief Time a loop that only passes its counter to doNotOptimize.
+ * \param iterations Number of iterations.
+ * \return Duration of the loop.
+ */
+[[nodiscard]] std::chrono::nanoseconds timeDoNotOptimizeLoop(int64_t iterations);
+
+/**
+ * \brief Time a loop that only writes to a buffer followed by clobberMemory.
+ * \param iterations Number of iterations.
+ * \return Duration of the loop.
+ */
+[[nodiscard]] std::chrono::nanoseconds timeClobberMemoryLoop(int64_t iterations);
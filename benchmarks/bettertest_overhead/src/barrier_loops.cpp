@@ -0,0 +1,30 @@
+#include "bettertest_overhead/barrier_loops.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/optimizer_barrier.h"
+
+std::chrono::nanoseconds timeDoNotOptimizeLoop(const int64_t iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < iterations; i++) bt::doNotOptimize(i);
+    return std::chrono::steady_clock::now() - start;
+}
+
+std::chrono::nanoseconds timeClobberMemoryLoop(const int64_t iterations)
+{
+    // Let the buffer escape, so that its stores are visible to clobberMemory.
+    int64_t  buffer[64] = {};
+    int64_t* data       = buffer;
+    bt::doNotOptimize(data);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < iterations; i++)
+    {
+        data[i & 63] = i;
+        bt::clobberMemory();
+    }
+    return std::chrono::steady_clock::now() - start;
+}
@@ -0,0 +1,383 @@
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/run.h"
+#include "bettertest/exceptions/better_test_error.h"
+#include "bettertest/mixins/compare_mixin.h"
+#include "bettertest/tests/performance_test.h"
+#include "bettertest/tests/unit_test.h"
+#include "bettertest/utils/environment.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest_overhead/barrier_loops.h"
+
+/*
+ * Measures the overhead of BetterTest itself: recording checks, resolving and running large numbers of tests, matching
+ * names and reading and writing suite files. Run it with an output directory and importer, e.g. with -f json, so that
+ * every run is compared against the previous ones and framework changes that slow down all suites are caught.
+ */
+
+/**
+ * \brief Stream that discards all output, so that printing results does not measure the console.
+ */
+std::ostream nullStream(nullptr);
+
+/**
+ * \brief Exporter that writes nothing, so that running tests does not measure the file system.
+ */
+class NullExporter final : public bt::IExporter
+{
+public:
+    NullExporter() : IExporter(std::filesystem::path{}) {}
+
+    void writeSuite(const bt::TestSuite&) override {}
+
+    void writeUnitTestResults(const bt::TestSuite&, const bt::IUnitTest&, const std::string&) override {}
+
+    void writePerformanceTestResults(const bt::TestSuite&, const bt::IPerformanceTest&, const std::string&) override
+    {
+    }
+};
+
+/**
+ * \brief Unit test without any checks.
+ */
+class Empty : public bt::UnitTest<Empty, bt::CompareMixin>
+{
+public:
+    void operator()() override {}
+};
+
+/**
+ * \brief Unit test that performs a fixed number of passing checks.
+ */
+class Checks : public bt::UnitTest<Checks, bt::CompareMixin>
+{
+public:
+    static constexpr int64_t count = 1000;
+
+    void operator()() override
+    {
+        for (int64_t i = 0; i < count; i++) compareEQ(i, i);
+    }
+};
+
+/**
+ * \brief Checks that loops that only feed optimizer barriers are not removed at -O3. A removed loop takes the same
+ * short time for any number of iterations, while a loop that is kept needs at least a cycle per iteration.
+ */
+class OptimizerBarriers : public bt::UnitTest<OptimizerBarriers, bt::CompareMixin>
+{
+public:
+    static constexpr int64_t iterations = 100'000'000;
+
+    /**
+     * \brief Lower bound of 0.05 ns per iteration, far below a cycle of any current CPU.
+     */
+    static constexpr auto minimum = std::chrono::nanoseconds(iterations / 20);
+
+    void operator()() override
+    {
+        compareGT(timeDoNotOptimizeLoop(iterations), minimum);
+        compareGT(timeClobberMemoryLoop(iterations), minimum);
+    }
+};
+
+/**
+ * \brief Runs a UnitTestRunner under a different name, so that many distinct tests can be created from one type.
+ */
+template<bt::IsUnitTest T>
+class NamedRunner final : public bt::ITestRunner
+{
+public:
+    explicit NamedRunner(std::string name) { setTestName(std::move(name)); }
+
+    std::pair<bool, std::string>
+      operator()(const bt::TestSuite& suite, bt::IExporter& exporter, std::ostream& out) noexcept override
+    {
+        return runner(suite, exporter, out);
+    }
+
+    [[nodiscard]] bool isParallel() const noexcept override { return runner.isParallel(); }
+
+private:
+    bt::UnitTestRunner<T> runner;
+};
+
+/**
+ * \brief Create a suite with the given number of empty unit tests and resolve them.
+ * \param count Number of tests.
+ * \return TestSuite.
+ */
+[[nodiscard]] std::unique_ptr<bt::TestSuite> createSuite(const int64_t count)
+{
+    auto suite = std::make_unique<bt::TestSuite>("overhead");
+    suite->setData(std::make_unique<bt::SuiteData>());
+    suite->getData().create(*suite);
+    for (int64_t i = 0; i < count; i++)
+        suite->addUnitTest(std::make_unique<NamedRunner<Empty>>(std::format("Empty{:06}", i)));
+    suite->getUnitTestSuite().resolveTests(*suite, nullStream);
+    return suite;
+}
+
+/**
+ * \brief Record passing checks with compareEQ.
+ */
+class RecordChecks : public bt::PerformanceTest<RecordChecks>
+{
+public:
+    void setUp() override { setItemsProcessed(Checks::count); }
+
+    void operator()() override
+    {
+        Checks t;
+        t.setOutput(nullStream);
+        t();
+        bt::doNotOptimize(t.passing());
+    }
+};
+
+/**
+ * \brief Record passing checks with compareEQ while concurrent recording is enabled.
+ */
+class RecordChecksConcurrent : public bt::PerformanceTest<RecordChecksConcurrent>
+{
+public:
+    void setUp() override { setItemsProcessed(Checks::count); }
+
+    void operator()() override
+    {
+        Checks t;
+        t.setOutput(nullStream);
+        t.setConcurrentRecording(true);
+        t();
+        t.endTest();
+        bt::doNotOptimize(t.passing());
+    }
+};
+
+/**
+ * \brief Resolve a suite of which all tests were resolved before, as happens when previous results were imported.
+ */
+class ResolveTests : public bt::PerformanceTest<ResolveTests>
+{
+public:
+    static constexpr auto arguments = bt::ArgumentRange::geometric(1'000, 100'000, 10);
+
+    static constexpr bt::BenchmarkOptions options{.repetitions = 5, .latencySamples = 0};
+
+    std::unique_ptr<bt::TestSuite> suite;
+
+    void setUp() override
+    {
+        suite = createSuite(getArgument());
+        setItemsProcessed(static_cast<double>(getArgument()));
+    }
+
+    void operator()() override { suite->getUnitTestSuite().resolveTests(*suite, nullStream); }
+};
+
+/**
+ * \brief Match test names against a filter of each kind.
+ */
+class MatchNames : public bt::PerformanceTest<MatchNames>
+{
+public:
+    bt::NameFilter filter{{"Empty000123", "Empty01*", "*999", "*Checks*"}};
+
+    std::vector<std::string> names;
+
+    void setUp() override
+    {
+        for (int64_t i = 0; i < 1000; i++) names.emplace_back(std::format("Empty{:06}", i));
+        setItemsProcessed(static_cast<double>(names.size()));
+    }
+
+    void operator()() override
+    {
+        for (const auto& name : names) bt::doNotOptimize(filter.match(name, true));
+    }
+};
+
+/**
+ * \brief Resolve and run a suite of empty tests, one after the other or in parallel. The parallel runner starts its own
+ * threads, so the CPU pinning of performance tests is lifted during each repetition to let them spread over all CPUs.
+ */
+template<bool Multithreaded>
+class RunTests : public bt::PerformanceTest<RunTests<Multithreaded>>
+{
+public:
+    static constexpr int64_t count = 1000;
+
+    static constexpr bt::BenchmarkOptions options{.latencySamples = 0};
+
+    std::unique_ptr<bt::TestSuite> suite;
+
+    NullExporter exporter;
+
+    void setUp() override
+    {
+        suite = createSuite(count);
+        suite->getUnitTestSuite().setMultithreaded(Multithreaded);
+        this->setItemsProcessed(count);
+    }
+
+    void setUpRepetition() override
+    {
+        if constexpr (Multithreaded) unpinning.emplace();
+    }
+
+    void tearDownRepetition() override { unpinning.reset(); }
+
+    void operator()() override { suite->getUnitTestSuite()(*suite, exporter, nullStream); }
+
+private:
+    std::optional<bt::CpuUnpinning> unpinning;
+};
+
+/**
+ * \brief Summarize the results of a suite of empty tests the way an exporter does, either by reading the columnar store
+ * directly or by creating a TestData object for each record, as the const list accessor of UnitTestSuite does.
+ */
+template<bool Columnar>
+class ReadResults : public bt::PerformanceTest<ReadResults<Columnar>>
+{
+public:
+    static constexpr int64_t count = 10'000;
+
+    std::unique_ptr<bt::TestSuite> suite;
+
+    NullExporter exporter;
+
+    void setUp() override
+    {
+        suite = createSuite(count);
+        suite->getUnitTestSuite()(*suite, exporter, nullStream);
+        if (!suite->getUnitTestSuite().isColumnar()) throw bt::BetterTestError("Suite of empty tests is not columnar");
+        this->setItemsProcessed(count);
+    }
+
+    void operator()() override
+    {
+        const auto&              store    = suite->getUnitTestSuite().getStore();
+        size_t                   passing  = 0;
+        std::chrono::nanoseconds duration = {};
+        if constexpr (Columnar)
+        {
+            for (size_t i = 0; i < store.size(); i++)
+            {
+                passing += store.isPassing(i);
+                duration += store.getDuration(i);
+            }
+        }
+        else
+        {
+            for (const auto& data : store.toTestData())
+            {
+                passing += data->passing;
+                duration += data->duration;
+            }
+        }
+        bt::doNotOptimize(passing);
+        bt::doNotOptimize(duration);
+    }
+};
+
+#if defined BETTERTEST_BUILD_JSON || defined BETTERTEST_BUILD_XML
+/**
+ * \brief Write the suite file of a suite with many tests.
+ */
+template<std::derived_from<bt::IExporter> E>
+class ExportSuite : public bt::PerformanceTest<ExportSuite<E>>
+{
+public:
+    static constexpr int64_t count = 10'000;
+
+    std::unique_ptr<bt::TestSuite> suite;
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "bettertest_overhead";
+
+    void setUp() override
+    {
+        suite = createSuite(count);
+        std::filesystem::create_directories(path);
+        this->setItemsProcessed(count);
+    }
+
+    void operator()() override
+    {
+        E exporter(path);
+        exporter.writeSuite(*suite);
+    }
+};
+
+/**
+ * \brief Read the suite file written by ExportSuite.
+ */
+template<std::derived_from<bt::IImporter> I, std::derived_from<bt::IExporter> E>
+class ImportSuite : public bt::PerformanceTest<ImportSuite<I, E>>
+{
+public:
+    static constexpr int64_t count = 10'000;
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "bettertest_overhead";
+
+    void setUp() override
+    {
+        const auto suite = createSuite(count);
+        std::filesystem::create_directories(path);
+        E exporter(path);
+        exporter.writeSuite(*suite);
+        this->setItemsProcessed(count);
+    }
+
+    void operator()() override
+    {
+        bt::TestSuite suite("overhead");
+        I             importer(path);
+        bt::doNotOptimize(importer.readSuite(suite));
+    }
+};
+#endif
+
+int main(int argc, char** argv)
+{
+    return bt::run<OptimizerBarriers,
+                   RecordChecks,
+                   RecordChecksConcurrent,
+                   ResolveTests,
+                   MatchNames,
+                   RunTests<false>,
+                   RunTests<true>,
+                   ReadResults<false>,
+                   ReadResults<true>
+#ifdef BETTERTEST_BUILD_JSON
+                   ,
+                   ExportSuite<bt::JsonExporter>,
+                   ImportSuite<bt::JsonImporter, bt::JsonExporter>
+#endif
+#ifdef BETTERTEST_BUILD_XML
+                   ,
+                   ExportSuite<bt::XmlExporter>,
+                   ImportSuite<bt::XmlImporter, bt::XmlExporter>
+#endif
+                   >(argc, argv, "bettertest_overhead");
+}
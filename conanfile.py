@@ -39,13 +39,15 @@ class BetterTestConan(ConanFile):
     options = {
         "build_alexandria": [True, False],
         "build_json": [True, False],
-        "build_xml": [True, False]
+        "build_xml": [True, False],
+        "replace_global_new": [True, False]
     }
     
     default_options = {
         "build_alexandria": False,
         "build_json": True,
         "build_xml": True,
+        "replace_global_new": False,
         "date/*:header_only": True,
         "date/*:use_system_tz_db": True
     }
@@ -127,6 +129,8 @@ class BetterTestConan(ConanFile):
             tc.variables["BETTERTEST_BUILD_JSON"] = True
         if self.options.build_xml:
             tc.variables["BETTERTEST_BUILD_XML"] = True
+        if self.options.replace_global_new:
+            tc.variables["BETTERTEST_REPLACE_GLOBAL_NEW"] = True
         
         tc.generate()
         
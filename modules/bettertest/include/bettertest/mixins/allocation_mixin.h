@@ -0,0 +1,97 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <functional>
+#include <memory>
+#include <source_location>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/mixins/mixin_interface.h"
+#include "bettertest/utils/allocation_tracking.h"
+
+namespace bt
+{
+    /**
+     * \brief The AllocationMixin counts the heap allocations performed on the thread running the test. The number of
+     * allocations, allocated bytes and peak live bytes of the whole test are recorded as metrics. Allocation budgets of
+     * individual pieces of code can be checked with expectNoAllocations and expectAllocationsAtMost. Allocations
+     * performed by other threads, e.g. a thread pool used by the code under test, are not counted. Requires the library
+     * to be built with BETTERTEST_REPLACE_GLOBAL_NEW, which is off by default. Otherwise all checks fail.
+     */
+    class AllocationMixin : public IMixin
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        static constexpr char type[] = "allocation";
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        AllocationMixin() = default;
+
+        AllocationMixin(const AllocationMixin&) = delete;
+
+        AllocationMixin(AllocationMixin&&) = delete;
+
+        ~AllocationMixin() noexcept override = default;
+
+        AllocationMixin& operator=(const AllocationMixin&) = delete;
+
+        AllocationMixin& operator=(AllocationMixin&&) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] std::string getType() const override;
+
+        ////////////////////////////////////////////////////////////////
+        // Test lifetime.
+        ////////////////////////////////////////////////////////////////
+
+        void beginTest() override;
+
+        void endTest() override;
+
+    protected:
+        ////////////////////////////////////////////////////////////////
+        // Allocations.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Invoke callable and check that it does not allocate.
+         * \param callable Callable.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        CheckResult expectNoAllocations(const std::function<void()>& callable,
+                                        const std::source_location&  loc = std::source_location::current());
+
+        /**
+         * \brief Invoke callable and check that it performs at most n allocations.
+         * \param n Maximum number of allocations.
+         * \param callable Callable.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        CheckResult expectAllocationsAtMost(size_t                       n,
+                                            const std::function<void()>& callable,
+                                            const std::source_location&  loc = std::source_location::current());
+
+    private:
+        /**
+         * \brief Scope tracking the allocations of the whole test.
+         */
+        std::unique_ptr<AllocationScope> testScope;
+    };
+}  // namespace bt
@@ -4,8 +4,10 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <format>
 #include <functional>
+#include <iterator>
 #include <ranges>
 #include <string>
 #include <source_location>
@@ -257,6 +259,159 @@ namespace bt
               lhs, std::views::repeat(rhs), std::forward<ProjA>(projectLhs), std::forward<ProjB>(projectRhs), loc);
         }
 
+        /**
+         * \brief lhs == rhs. Compare two unordered containers for equality, irrespective of the order of their
+         * elements. Runs in expected linear time by looking up the elements of lhs in rhs. For multisets and multimaps,
+         * elements with equivalent keys are compared as unordered groups.
+         * \tparam A Type of left-hand side.
+         * \tparam B Type of right-hand side.
+         * \param lhs Left-hand side of comparison.
+         * \param rhs Right-hand side of comparison.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        template<type_traits::unordered_container A, type_traits::unordered_container B>
+            requires(type_traits::comparable_eq<typename A::value_type, typename B::value_type> &&
+                     requires(const B& b, const typename A::key_type& key) { b.equal_range(key); })
+        CheckResult compareUnorderedEQ(const A&                    lhs,
+                                       const B&                    rhs,
+                                       const std::source_location& loc = std::source_location::current())
+        {
+            try
+            {
+                if (lhs.size() != rhs.size())
+                    return recordResult(
+                      result_t::failure, loc, std::format("size lhs[{0}] != size rhs[{1}]", lhs.size(), rhs.size()));
+
+                for (auto it = lhs.begin(); it != lhs.end();)
+                {
+                    const auto& key = getKey<A>(*it);
+
+                    // Unique keys, compare single element.
+                    if constexpr (type_traits::unique_keys<A> && type_traits::unique_keys<B>)
+                    {
+                        const auto other = rhs.find(key);
+                        if (other == rhs.end())
+                            return recordResult(
+                              result_t::failure, loc, std::format("key {0} of lhs not found in rhs", toString(key)));
+
+                        if (!(*it == *other))
+                        {
+                            if constexpr (type_traits::associative_map<A> && type_traits::associative_map<B>)
+                                return recordResult(result_t::failure,
+                                                    loc,
+                                                    std::format("{1} == {2} at key {0}",
+                                                                toString(key),
+                                                                toString(it->second),
+                                                                toString(other->second)));
+                            else
+                                return recordResult(result_t::failure,
+                                                    loc,
+                                                    std::format("{0} == {1}", toString(*it), toString(*other)));
+                        }
+
+                        ++it;
+                    }
+                    // Equivalent keys, compare groups of elements as multisets.
+                    else
+                    {
+                        const auto [first0, last0] = lhs.equal_range(key);
+                        const auto [first1, last1] = rhs.equal_range(key);
+                        const auto count0          = std::distance(first0, last0);
+                        const auto count1          = std::distance(first1, last1);
+                        if (count0 != count1)
+                            return recordResult(result_t::failure,
+                                                loc,
+                                                std::format("count lhs[{1}] != count rhs[{2}] at key {0}",
+                                                            toString(key),
+                                                            count0,
+                                                            count1));
+
+                        if (!std::is_permutation(first0, last0, first1, last1))
+                            return recordResult(
+                              result_t::failure, loc, std::format("elements differ at key {0}", toString(key)));
+
+                        it = last0;
+                    }
+                }
+            }
+            catch (...)
+            {
+                return recordResult(result_t::exception, loc, "exception while comparing unordered containers");
+            }
+
+            return recordResult(result_t::success, loc, "");
+        }
+
+        /**
+         * \brief lhs[k] == rhs[k] for all keys k. Compare two maps key by key. On failure, reports the keys that only
+         * exist in lhs, the keys that only exist in rhs and the keys with differing values. Runs in expected linear
+         * time for unordered maps.
+         * \tparam A Type of left-hand side.
+         * \tparam B Type of right-hand side.
+         * \param lhs Left-hand side of comparison.
+         * \param rhs Right-hand side of comparison.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        template<type_traits::associative_map A, type_traits::associative_map B>
+            requires(type_traits::unique_keys<A> && type_traits::unique_keys<B> &&
+                     type_traits::comparable_eq<typename A::mapped_type, typename B::mapped_type> &&
+                     requires(const A& a, const B& b, const typename A::key_type& k0, const typename B::key_type& k1) {
+                         b.find(k0);
+                         a.find(k1);
+                     })
+        CheckResult
+          compareMapEQ(const A& lhs, const B& rhs, const std::source_location& loc = std::source_location::current())
+        {
+            size_t      onlyLhs   = 0;
+            size_t      onlyRhs   = 0;
+            size_t      differing = 0;
+            std::string onlyLhsKeys;
+            std::string onlyRhsKeys;
+            std::string differingKeys;
+
+            try
+            {
+                size_t matched = 0;
+                for (const auto& [key, value] : lhs)
+                {
+                    const auto other = rhs.find(key);
+                    if (other == rhs.end())
+                        appendKey(onlyLhsKeys, ++onlyLhs, key);
+                    else
+                    {
+                        matched++;
+                        if (compare_eq(value, other->second) != result_t::success)
+                            appendKey(differingKeys, ++differing, key);
+                    }
+                }
+
+                // All keys of rhs that were not matched only exist in rhs. Only look them up if there are any.
+                if (matched != rhs.size())
+                {
+                    for (const auto& [key, value] : rhs)
+                    {
+                        if (lhs.find(key) == lhs.end()) appendKey(onlyRhsKeys, ++onlyRhs, key);
+                        if (matched + onlyRhs == rhs.size()) break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                return recordResult(result_t::exception, loc, "exception while comparing maps");
+            }
+
+            if (onlyLhs == 0 && onlyRhs == 0 && differing == 0) return recordResult(result_t::success, loc, "");
+
+            std::string error = std::format("map lhs[{0}] != map rhs[{1}]", lhs.size(), rhs.size());
+            if (onlyLhs > 0) error += std::format("\n    {0} key(s) only in lhs: {1}", onlyLhs, onlyLhsKeys);
+            if (onlyRhs > 0) error += std::format("\n    {0} key(s) only in rhs: {1}", onlyRhs, onlyRhsKeys);
+            if (differing > 0)
+                error += std::format("\n    {0} key(s) with differing values: {1}", differing, differingKeys);
+            return recordResult(result_t::failure, loc, std::move(error));
+        }
+
         /**
          * \brief lhs != rhs. Compare two values for inequality.
          * \tparam A Type of left-hand side.
@@ -386,6 +541,33 @@ namespace bt
                                                                        toString(upper));
             return recordResult(res, loc, std::move(error));
         }
+
+    private:
+        /**
+         * \brief Maximum number of keys listed per category in the error message of compareMapEQ.
+         */
+        static constexpr size_t maxReportedKeys = 8;
+
+        template<type_traits::associative_container C>
+        [[nodiscard]] static const auto& getKey(const typename C::value_type& value) noexcept
+        {
+            if constexpr (type_traits::associative_map<C>)
+                return value.first;
+            else
+                return value;
+        }
+
+        template<typename K>
+        static void appendKey(std::string& keys, const size_t count, const K& key)
+        {
+            if (count <= maxReportedKeys)
+            {
+                if (count > 1) keys += ", ";
+                keys += toString(key);
+            }
+            else if (count == maxReportedKeys + 1)
+                keys += ", ...";
+        }
     };
 
     constexpr CompareMixin::RequireEqualLength RequireEqualLength   = CompareMixin::RequireEqualLength::True;
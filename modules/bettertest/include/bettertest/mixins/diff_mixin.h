@@ -0,0 +1,93 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/mixins/mixin_interface.h"
+#include "bettertest/utils/diff.h"
+
+namespace bt
+{
+    /**
+     * \brief The DiffMixin compares large strings and byte spans. Instead of printing both values in full on failure,
+     * only the location of the first mismatch and a bounded unified diff excerpt of the changed region are recorded.
+     */
+    class DiffMixin : public IMixin
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        static constexpr char type[] = "diff";
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        DiffMixin() = default;
+
+        DiffMixin(const DiffMixin&) = delete;
+
+        DiffMixin(DiffMixin&&) = delete;
+
+        ~DiffMixin() noexcept override = default;
+
+        DiffMixin& operator=(const DiffMixin&) = delete;
+
+        DiffMixin& operator=(DiffMixin&&) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] std::string getType() const override;
+
+    protected:
+        ////////////////////////////////////////////////////////////////
+        // Comparisons.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief lhs == rhs. Compare two strings. On failure, records a line based diff excerpt.
+         * \param lhs Left-hand side of comparison.
+         * \param rhs Right-hand side of comparison.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        CheckResult compareTextEQ(std::string_view            lhs,
+                                  std::string_view            rhs,
+                                  const std::source_location& loc = std::source_location::current());
+
+        /**
+         * \brief lhs == rhs. Compare two byte spans. On failure, records a hexadecimal diff excerpt.
+         * \param lhs Left-hand side of comparison.
+         * \param rhs Right-hand side of comparison.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        CheckResult compareBytesEQ(std::span<const std::byte>  lhs,
+                                   std::span<const std::byte>  rhs,
+                                   const std::source_location& loc = std::source_location::current());
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Options bounding the size of recorded diffs.
+         */
+        DiffOptions diffOptions;
+    };
+}  // namespace bt
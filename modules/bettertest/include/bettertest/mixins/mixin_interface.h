@@ -4,7 +4,9 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <cstdint>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -14,6 +16,7 @@
 
 #include "bettertest/utils/check_result.h"
 #include "bettertest/utils/result.h"
+#include "bettertest/utils/thread_buffers.h"
 
 namespace bt
 {
@@ -84,6 +87,12 @@ namespace bt
          */
         [[nodiscard]] const std::vector<Result>& getResults() const noexcept;
 
+        /**
+         * \brief Get the full list of metrics.
+         * \return List of metrics.
+         */
+        [[nodiscard]] const std::vector<Metric>& getMetrics() const noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Setters.
         ////////////////////////////////////////////////////////////////
@@ -94,9 +103,69 @@ namespace bt
          */
         void setOutput(std::ostream& output);
 
+        ////////////////////////////////////////////////////////////////
+        // Concurrency.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Enable or disable concurrent recording. When enabled, checks can be performed from any thread. Each
+         * thread records into its own buffer and counters are updated atomically. Buffers are merged into the list of
+         * results and the output stream by mergeResults. Disabling concurrent recording merges any pending results.
+         * \param concurrent Enable concurrent recording.
+         */
+        void setConcurrentRecording(bool concurrent);
+
+        /**
+         * \brief Returns whether concurrent recording is enabled.
+         * \return True or false.
+         */
+        [[nodiscard]] bool isConcurrentRecording() const noexcept;
+
+        /**
+         * \brief Merge the per-thread buffers of concurrent recording into the list of results and write their output.
+         * Must not be called while other threads are still performing checks.
+         */
+        void mergeResults();
+
+        ////////////////////////////////////////////////////////////////
+        // Test lifetime.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Called on the thread running the test, right before the test is invoked.
+         */
+        virtual void beginTest();
+
+        /**
+         * \brief Called on the thread running the test after the test has returned or thrown. The default
+         * implementation merges any concurrently recorded results.
+         */
+        virtual void endTest();
+
     protected:
         [[nodiscard]] CheckResult recordResult(result_t r, const std::source_location& loc, const std::string& error);
 
+        /**
+         * \brief Record a named measurement. Metrics are exported alongside the results.
+         * \param name Metric name.
+         * \param value Value.
+         */
+        void recordMetric(std::string name, double value);
+
+    private:
+        /**
+         * \brief Results and output of a single thread during concurrent recording.
+         */
+        struct ThreadBuffer
+        {
+            std::vector<Result> results;
+            std::ostringstream  output;
+        };
+
+        [[nodiscard]] CheckResult
+          recordResultConcurrent(result_t r, const std::source_location& loc, std::string error);
+
+    protected:
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
@@ -108,6 +177,13 @@ namespace bt
 
         std::vector<Result> results;
 
+        std::vector<Metric> metrics;
+
         std::ostream* out = nullptr;
+
+    private:
+        bool concurrentRecording = false;
+
+        ThreadBuffers<ThreadBuffer> buffers;
     };
 }  // namespace bt
@@ -4,8 +4,8 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
-#include <memory>
-#include <vector>
+#include <ranges>
+#include <span>
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
@@ -15,48 +15,26 @@
 
 namespace bt
 {
-    struct IMixinResultsGetter
+    class ITest;
+
+    /**
+     * \brief Function that retrieves one of the mixins of a test. Tests hold a static table of these, one for each
+     * mixin they derive from.
+     */
+    using mixin_getter_t = const IMixin& (*)(const ITest&) noexcept;
+
+    /**
+     * \brief Binds a test to the getters in its static table.
+     */
+    struct MixinResultsGetter
     {
-        IMixinResultsGetter() = default;
+        [[nodiscard]] const IMixin* operator()(const mixin_getter_t getter) const noexcept { return &getter(*test); }
 
-        IMixinResultsGetter(const IMixinResultsGetter&) = default;
-
-        IMixinResultsGetter(IMixinResultsGetter&&) noexcept = default;
-
-        virtual ~IMixinResultsGetter() = default;
-
-        IMixinResultsGetter& operator=(const IMixinResultsGetter&) = default;
-
-        IMixinResultsGetter& operator=(IMixinResultsGetter&&) noexcept = default;
-
-        [[nodiscard]] virtual size_t getTotal() const noexcept = 0;
-
-        [[nodiscard]] virtual size_t getSuccesses() const noexcept = 0;
-
-        [[nodiscard]] virtual size_t getFailures() const noexcept = 0;
-
-        [[nodiscard]] virtual size_t getExceptions() const noexcept = 0;
-
-        [[nodiscard]] virtual const std::vector<Result>& getResults() const noexcept = 0;
+        const ITest* test = nullptr;
     };
 
-    using IMixinResultsGetterPtr = std::unique_ptr<IMixinResultsGetter>;
-
-    template<typename T>
-    struct MixinResultsGetter final : IMixinResultsGetter
-    {
-        explicit MixinResultsGetter(const T& m) : mixin(&m) {}
-
-        [[nodiscard]] size_t getTotal() const noexcept override { return mixin->getTotal(); }
-
-        [[nodiscard]] size_t getSuccesses() const noexcept override { return mixin->getSuccesses(); }
-
-        [[nodiscard]] size_t getFailures() const noexcept override { return mixin->getFailures(); }
-
-        [[nodiscard]] size_t getExceptions() const noexcept override { return mixin->getExceptions(); }
-
-        [[nodiscard]] const std::vector<Result>& getResults() const noexcept override { return mixin->getResults(); }
-
-        const T* mixin = nullptr;
-    };
+    /**
+     * \brief View over all mixins of a test. Elements are const IMixin pointers from which results can be retrieved.
+     */
+    using MixinResultsView = std::ranges::transform_view<std::span<const mixin_getter_t>, MixinResultsGetter>;
 }  // namespace bt
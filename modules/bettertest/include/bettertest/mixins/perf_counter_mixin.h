@@ -0,0 +1,133 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <functional>
+#include <source_location>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/mixins/mixin_interface.h"
+#include "bettertest/utils/perf_counters.h"
+
+namespace bt
+{
+    /**
+     * \brief The PerfCounterMixin measures a callable with hardware performance counters and checks the counts against
+     * a budget. All measured counts are recorded as metrics named "<event>:<line>". If hardware counters are not
+     * permitted, only the CPU time is recorded and budget checks pass with a "counter unavailable" message, so that
+     * tests do not fail on Windows or in containers. Call setCountersRequired to make them fail instead.
+     */
+    class PerfCounterMixin : public IMixin
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        static constexpr char type[] = "perf";
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        PerfCounterMixin() = default;
+
+        PerfCounterMixin(const PerfCounterMixin&) = delete;
+
+        PerfCounterMixin(PerfCounterMixin&&) = delete;
+
+        ~PerfCounterMixin() noexcept override = default;
+
+        PerfCounterMixin& operator=(const PerfCounterMixin&) = delete;
+
+        PerfCounterMixin& operator=(PerfCounterMixin&&) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] std::string getType() const override;
+
+        /**
+         * \brief Returns whether budget checks fail if their counter is unavailable.
+         * \return True or false.
+         */
+        [[nodiscard]] bool areCountersRequired() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief If enabled budget checks fail if their counter is unavailable, instead of passing with a "counter
+         * unavailable" message. Disabled by default.
+         * \param required Fail if counters are unavailable.
+         */
+        void setCountersRequired(bool required) noexcept;
+
+    protected:
+        ////////////////////////////////////////////////////////////////
+        // Counters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Invoke callable and measure it with performance counters. Counts are recorded as metrics.
+         * \param callable Callable.
+         * \param loc Automatic source_location.
+         * \return Counts.
+         */
+        PerfCounts measure(const std::function<void()>& callable,
+                           const std::source_location&  loc = std::source_location::current());
+
+        /**
+         * \brief Invoke callable and check that it retires at most n instructions.
+         * \param n Maximum number of instructions.
+         * \param callable Callable.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        CheckResult expectInstructionsAtMost(uint64_t                     n,
+                                             const std::function<void()>& callable,
+                                             const std::source_location&  loc = std::source_location::current());
+
+        /**
+         * \brief Invoke callable and check that it causes at most n cache misses.
+         * \param n Maximum number of cache misses.
+         * \param callable Callable.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        CheckResult expectCacheMissesAtMost(uint64_t                     n,
+                                            const std::function<void()>& callable,
+                                            const std::source_location&  loc = std::source_location::current());
+
+        /**
+         * \brief Invoke callable and check that it causes at most n branch mispredictions.
+         * \param n Maximum number of branch mispredictions.
+         * \param callable Callable.
+         * \param loc Automatic source_location.
+         * \return Result.
+         */
+        CheckResult expectBranchMissesAtMost(uint64_t                     n,
+                                             const std::function<void()>& callable,
+                                             const std::source_location&  loc = std::source_location::current());
+
+    private:
+        [[nodiscard]] CheckResult expectEventAtMost(perf_event_t                 event,
+                                                    uint64_t                     n,
+                                                    const std::function<void()>& callable,
+                                                    const std::source_location&  loc);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        bool countersRequired = false;
+    };
+}  // namespace bt
@@ -11,6 +11,7 @@
 namespace bt
 {
     class IExporter;
+    class IPerformanceTest;
     class IUnitTest;
     class TestSuite;
 
@@ -50,6 +51,16 @@ namespace bt
          */
         virtual void writeUnitTestResults(const TestSuite& suite, const IUnitTest& test, const std::string& name) = 0;
 
+        /**
+         * \brief Write performance test results.
+         * \param suite The test suite object.
+         * \param test The performance test object.
+         * \param name The name of the performance test.
+         */
+        virtual void writePerformanceTestResults(const TestSuite&        suite,
+                                                 const IPerformanceTest& test,
+                                                 const std::string&      name) = 0;
+
     protected:
         /**
          * \brief Output directory.
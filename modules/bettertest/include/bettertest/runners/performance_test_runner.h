@@ -4,22 +4,50 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "bettertest/exceptions/check_fatal_error.h"
+#include "bettertest/output/exporter_interface.h"
 #include "bettertest/runners/test_runner_interface.h"
+#include "bettertest/suite/performance_test_data.h"
 #include "bettertest/tests/performance_test.h"
+#include "bettertest/utils/benchmark.h"
+#include "bettertest/utils/cache.h"
 #include "bettertest/utils/class_name.h"
+#include "bettertest/utils/complexity.h"
+#include "bettertest/utils/environment.h"
+#include "bettertest/utils/histogram.h"
+#include "bettertest/utils/profiler.h"
+#include "bettertest/utils/timer.h"
 
 namespace bt
 {
+    /**
+     * \brief When invoked, the PerformanceTestRunner creates a performance test of the given type and measures it.
+     * \tparam T PerformanceTest.
+     */
     template<IsPerformanceTest T>
     class PerformanceTestRunner final : public ITestRunner
     {
     public:
+        using test_t = T;
+
         PerformanceTestRunner()
         {
             if constexpr (hasExplicitName<T>)
@@ -38,25 +66,338 @@ namespace bt
 
         PerformanceTestRunner& operator=(PerformanceTestRunner&&) = default;
 
-        std::pair<bool, std::string> operator()(const TestSuite&, IExporter&, std::ostream&) noexcept override
+        std::pair<bool, std::string>
+          operator()(const TestSuite& suite, IExporter& exporter, std::ostream& out) noexcept override
         {
-            // Access this to shut up static analysis for now.
-            static_cast<void>(this);
+            bool              passing = false;
+            std::stringstream error;
 
-            return std::make_pair(false, std::string());
-#if 0
+            // Try to run test.
+            T t;
             try
             {
-                T t;
-                t();
-                exporter.writePerformanceTestFile(t, getTestName());
-                return t.passing();
+                t.setOutput(out);
+                t.beginTest();
+
+                // The test type is known here, so the call to the test is not virtual.
+                const auto& timer = Timer::get();
+                const auto  batch = [&t, &timer](const uint64_t iterations) {
+                    t.setUpRepetition();
+                    resetPausedTime();
+                    const auto start = timer.now();
+                    for (uint64_t i = 0; i < iterations; i++) runIteration(t);
+                    const auto elapsed = getUnpausedTime(start, timer.now());
+                    t.tearDownRepetition();
+                    return elapsed;
+                };
+                const auto sample = [&t, &timer](const uint64_t iterations, Histogram& histogram) {
+                    t.setUpRepetition();
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        resetPausedTime();
+                        const auto start = timer.now();
+                        runIteration(t);
+                        histogram.record(static_cast<uint64_t>(getUnpausedTime(start, timer.now()).count()));
+                    }
+                    t.tearDownRepetition();
+                };
+
+                // With cold caches, each iteration is timed individually so that evicting can be left out.
+                std::optional<CacheEvictor> evictor;
+                const auto                  coldBatch = [&t, &timer, &evictor](const uint64_t iterations) {
+                    std::chrono::nanoseconds elapsed{0};
+                    t.setUpRepetition();
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        t.evictCaches(*evictor);
+                        resetPausedTime();
+                        const auto start = timer.now();
+                        runIteration(t);
+                        elapsed += getUnpausedTime(start, timer.now());
+                    }
+                    t.tearDownRepetition();
+                    return elapsed;
+                };
+                const std::array<batch_function_t, 2> batches = {batch, coldBatch};
+
+                const auto threadCounts = getThreadCounts();
+                const auto options      = getOptions();
+                const auto cacheModes   = getCacheModes();
+                if (std::ranges::any_of(threadCounts, [](const int64_t n) { return n > 1; }))
+                    t.setConcurrentRecording(true);
+                if (options.cacheMode != cache_mode_t::warm) evictor.emplace();
+
+                // Sample call stacks while measuring, if enabled.
+                std::optional<SamplingProfiler> profiler;
+                const auto                      profilePath = getProfilePath(suite, getTestName());
+                if (profilePath) profiler.emplace();
+
+                auto  regressed   = false;
+                auto  inefficient = false;
+                auto* data        = findPerformanceTestData(suite, getTestName());
+                for (const auto argument : getArguments())
+                {
+                    t.setArgument(argument);
+                    if constexpr (hasArguments()) out << "  Argument " << argument << "\n";
+
+                    // Results of the smallest thread count, for each cache mode.
+                    std::array<std::optional<BenchmarkResults>, 2> references;
+                    for (const auto threads : threadCounts)
+                    {
+                        t.setThreadCount(static_cast<size_t>(threads));
+                        if constexpr (hasThreads()) out << "  Threads " << threads << "\n";
+
+                        std::optional<BenchmarkResults> warm;
+                        for (const auto cache : cacheModes)
+                        {
+                            const auto cold        = cache == cache_mode_t::cold;
+                            const auto modeOptions = getCacheModeOptions(options, cache);
+                            t.setUp();
+
+                            if (profiler && !profiler->start())
+                            {
+                                out << "  Could not start the profiler, not profiling this test\n";
+                                profiler.reset();
+                            }
+                            const auto& measured  = batches[cold ? 1 : 0];
+                            const auto  throttles = readThrottleCount();
+                            auto        results   = runBenchmark(measured, modeOptions, static_cast<size_t>(threads));
+                            results.argument      = argument;
+                            results.cache         = cache;
+                            results.throttled     = readThrottleCount() != throttles;
+                            results.counters      = computeCounterRates(t.getCounters(), results);
+                            if (profiler) profiler->stop();
+
+                            // Time individual iterations to capture the tail latencies hidden by the batch times. Cold
+                            // measurements already time individual iterations.
+                            if (!cold && options.latencySamples > 0)
+                                results.distribution = measureLatencyDistribution(sample, options, results);
+
+                            // Compare throughput per thread against the smallest thread count.
+                            if constexpr (hasThreads())
+                            {
+                                auto& reference = references[cold ? 1 : 0];
+                                if (!reference) reference = results;
+                                results.efficiency = computeEfficiency(results, *reference);
+                            }
+
+                            if (options.cacheMode != cache_mode_t::warm) out << (cold ? "  Cold" : "  Warm") << "\n";
+                            printBenchmarkResults(out, results);
+
+                            if (results.efficiency && *results.efficiency < options.minEfficiency)
+                            {
+                                out << std::format("    Parallel efficiency is below the minimum of {:.1f}%\n",
+                                                   options.minEfficiency * 100);
+                                inefficient = true;
+                            }
+
+                            // Compare against previous runs.
+                            if (data) regressed = !data->addResults(suite, results, options, out) || regressed;
+
+                            if (!cold)
+                                warm = results;
+                            else if (warm)
+                                printCacheComparison(out, *warm, results);
+
+                            t.addBenchmarkResults(std::move(results));
+                        }
+                    }
+                }
+
+                // Fit complexity over all arguments at the smallest thread count and first cache mode, and compare
+                // against the expected complexity.
+                const auto isFitted = [&](const BenchmarkResults& r) {
+                    return r.threads == static_cast<size_t>(threadCounts.front()) && r.cache == cacheModes.front();
+                };
+                std::vector<BenchmarkResults> fitted;
+                std::ranges::copy_if(t.getBenchmarkResults(), std::back_inserter(fitted), isFitted);
+                auto complex = false;
+                if (hasArguments() && fitted.size() > 1)
+                {
+                    const auto fit = fitBenchmarkComplexity(fitted);
+                    printComplexityFit(out, fit, getExpectedComplexity());
+                    complex = getExpectedComplexity() && fit.complexity > *getExpectedComplexity();
+                    t.setComplexityFit(fit);
+                }
+
+                if (profiler)
+                {
+                    if (profiler->writeFoldedStacks(*profilePath))
+                        out << std::format("  Profile of {} samples written to {}\n",
+                                           profiler->getSampleCount(),
+                                           profilePath->string());
+                    else
+                        out << "  Could not write profile to " << profilePath->string() << "\n";
+                }
+
+                passing = !regressed && !complex && !inefficient && t.passing();
+            }
+
+            // Catch any exceptions.
+            catch (const CheckFatalError& e)
+            {
+                error << "Test terminated because of failed check: "
+                      << (e.getMessage().empty() ? "<no message>" : e.getMessage());
+            }
+            catch (const BetterTestError& e)
+            {
+                error << "BetterTestError: " << e.what();
+            }
+            catch (const std::exception& e)
+            {
+                error << "Exception: " << e.what();
+            }
+            catch (...)
+            {
+                error << "An unknown error occurred";
+            }
+
+            // Let mixins finish their measurements.
+            t.endTest();
+
+            // Write test results.
+            exporter.writePerformanceTestResults(suite, t, getTestName());
+
+            return std::make_pair(passing, error.str());
+        }
+
+        /**
+         * \brief Run a single iteration of a test. Per-iteration set up and tear down are excluded from the measured
+         * time by pausing, if the test overrides them.
+         * \param t Test.
+         */
+        static void runIteration(T& t)
+        {
+            if constexpr (hasIterationSetUp())
+            {
+                pauseTiming();
+                t.setUpIteration();
+                resumeTiming();
             }
-            catch (std::exception& e)
+
+            t();
+
+            if constexpr (hasIterationTearDown())
+            {
+                pauseTiming();
+                t.tearDownIteration();
+                resumeTiming();
+            }
+        }
+
+        /**
+         * \brief Returns whether the test held by this runner overrides setUpIteration.
+         * \return True or false.
+         */
+        [[nodiscard]] static constexpr bool hasIterationSetUp() noexcept
+        {
+            return !std::same_as<decltype(&test_t::setUpIteration), void (IPerformanceTest::*)()>;
+        }
+
+        /**
+         * \brief Returns whether the test held by this runner overrides tearDownIteration.
+         * \return True or false.
+         */
+        [[nodiscard]] static constexpr bool hasIterationTearDown() noexcept
+        {
+            return !std::same_as<decltype(&test_t::tearDownIteration), void (IPerformanceTest::*)()>;
+        }
+
+        /**
+         * \brief Performance tests never run in parallel, so that other tests do not disturb the measurements.
+         * \return False.
+         */
+        [[nodiscard]] bool isParallel() const noexcept override { return false; }
+
+        /**
+         * \brief Returns whether the test held by this runner is swept over a range of arguments.
+         * \return True or false.
+         */
+        [[nodiscard]] static constexpr bool hasArguments() noexcept { return requires { test_t::arguments; }; }
+
+        /**
+         * \brief Get the arguments over which the test held by this runner is swept.
+         * \return List of arguments. A single 0 for tests without arguments.
+         */
+        [[nodiscard]] static std::vector<int64_t> getArguments()
+        {
+            // If test has a static member arguments, expand it. It can be an ArgumentRange or a range of integers.
+            if constexpr (requires { test_t::arguments.expand(); })
+                return test_t::arguments.expand();
+            else if constexpr (hasArguments())
+                return std::vector<int64_t>(std::ranges::begin(test_t::arguments), std::ranges::end(test_t::arguments));
+            else
+                return {0};
+        }
+
+        /**
+         * \brief Returns whether the test held by this runner is swept over a range of thread counts.
+         * \return True or false.
+         */
+        [[nodiscard]] static constexpr bool hasThreads() noexcept { return requires { test_t::threads; }; }
+
+        /**
+         * \brief Get the thread counts over which the test held by this runner is swept, with hardwareThreads resolved.
+         * \return List of thread counts. A single 1 for tests without thread counts.
+         */
+        [[nodiscard]] static std::vector<int64_t> getThreadCounts()
+        {
+            // If test has a static member threads, expand it. It can be an ArgumentRange or a range of integers.
+            std::vector<int64_t> counts;
+            if constexpr (requires { test_t::threads.expand(); })
+            {
+                auto range  = test_t::threads;
+                range.first = resolveThreadCount(range.first);
+                range.last  = resolveThreadCount(range.last);
+                counts      = range.expand();
+            }
+            else if constexpr (hasThreads())
+            {
+                for (const auto n : test_t::threads) counts.push_back(resolveThreadCount(n));
+            }
+            else
+                counts.push_back(1);
+            return counts;
+        }
+
+        /**
+         * \brief Get the cache modes in which the test held by this runner is measured, in order.
+         * \return List of warm and/or cold.
+         */
+        [[nodiscard]] static std::vector<cache_mode_t> getCacheModes()
+        {
+            switch (getOptions().cacheMode)
             {
-                return false;
+            case cache_mode_t::cold: return {cache_mode_t::cold};
+            case cache_mode_t::both: return {cache_mode_t::warm, cache_mode_t::cold};
+            default: return {cache_mode_t::warm};
             }
-#endif
+        }
+
+        /**
+         * \brief Get the complexity that the test held by this runner is expected to have at most.
+         * \return Complexity, or empty if there is no expectation.
+         */
+        [[nodiscard]] static constexpr std::optional<complexity_t> getExpectedComplexity() noexcept
+        {
+            // If test has a static member complexity, use that. Otherwise, there is no expectation.
+            if constexpr (requires { test_t::complexity; })
+                return test_t::complexity;
+            else
+                return std::nullopt;
+        }
+
+        /**
+         * \brief Get the options with which the test held by this runner is measured.
+         * \return BenchmarkOptions.
+         */
+        [[nodiscard]] static constexpr BenchmarkOptions getOptions() noexcept
+        {
+            // If test has a static member options, use that. Otherwise, use the defaults.
+            if constexpr (requires(test_t) { test_t::options; })
+                return test_t::options;
+            else
+                return {};
         }
     };
 }  // namespace bt
@@ -10,6 +10,12 @@
 #include <string>
 #include <utility>
 
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/isolation.h"
+
 namespace bt
 {
     class IExporter;
@@ -52,6 +58,12 @@ namespace bt
          */
         [[nodiscard]] virtual bool isParallel() const noexcept = 0;
 
+        /**
+         * \brief Get the resource limits of the test held by this runner when it runs in an isolated process.
+         * \return Resource limits. Limits that are not set are taken from the suite.
+         */
+        [[nodiscard]] virtual ResourceLimits getResourceLimits() const noexcept { return {}; }
+
     protected:
         /**
          * \brief Set the name of the test this runner holds.
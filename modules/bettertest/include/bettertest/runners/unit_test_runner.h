@@ -59,6 +59,8 @@ namespace bt
             try
             {
                 t.setOutput(out);
+                t.setConcurrentRecording(isConcurrent());
+                t.beginTest();
                 t();
                 passing = t.passing();
             }
@@ -82,6 +84,9 @@ namespace bt
                 error << "An unknown error occurred";
             }
 
+            // Let mixins finish their measurements and collect results that were recorded concurrently.
+            t.endTest();
+
             // Write test results.
             exporter.writeUnitTestResults(suite, t, getTestName());
 
@@ -101,5 +106,33 @@ namespace bt
             else
                 return true;
         }
+
+        /**
+         * \brief Get the resource limits of the test held by this runner when it runs in an isolated process.
+         * \return Resource limits. Limits that are not set are taken from the suite.
+         */
+        [[nodiscard]] ResourceLimits getResourceLimits() const noexcept override
+        {
+            // If test has a static member limits, use that to limit the resources of the test.
+            // Otherwise, default to the limits of the suite.
+            if constexpr (requires(test_t) { test_t::limits; })
+                return test_t::limits;
+            else
+                return {};
+        }
+
+        /**
+         * \brief Returns whether the test held by this runner records checks concurrently, allowing checks to be performed from any thread.
+         * \return True or false.
+         */
+        [[nodiscard]] static constexpr bool isConcurrent() noexcept
+        {
+            // If test has a static member isConcurrent, use that to determine if checks are recorded concurrently.
+            // Otherwise, default to false.
+            if constexpr (requires(test_t) { test_t::isConcurrent; })
+                return test_t::isConcurrent;
+            else
+                return false;
+        }
     };
 }  // namespace bt
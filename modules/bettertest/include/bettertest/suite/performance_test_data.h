@@ -0,0 +1,146 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/suite/test_data.h"
+#include "bettertest/utils/benchmark.h"
+
+namespace bt
+{
+    /**
+     * \brief The PerformanceTestData class extends TestData with the samples of previous runs, which form the baseline
+     * that new results are compared against.
+     */
+    class PerformanceTestData : public TestData
+    {
+    public:
+        /**
+         * \brief Unique type name.
+         */
+        static constexpr char type[] = "performance";
+
+        /**
+         * \brief Samples of a single run.
+         */
+        struct Run
+        {
+            /**
+             * \brief SuiteData::runIndex of the run.
+             */
+            size_t runIndex = 0;
+
+            /**
+             * \brief BenchmarkResults::argument of the run.
+             */
+            int64_t argument = 0;
+
+            /**
+             * \brief BenchmarkResults::threads of the run.
+             */
+            size_t threads = 1;
+
+            /**
+             * \brief BenchmarkResults::cache of the run.
+             */
+            cache_mode_t cache = cache_mode_t::warm;
+
+            /**
+             * \brief Name of the counter whose rates were recorded, or empty if times were recorded.
+             */
+            std::string metric;
+
+            /**
+             * \brief Time per iteration of each repetition, or the rate of the metric counter.
+             */
+            std::vector<double> samples;
+
+            /**
+             * \brief Encoded latency histogram of the run. Empty if none was recorded.
+             */
+            std::string histogram;
+
+            /**
+             * \brief False if the environment was unfit or the CPU was throttled. Unstable runs are not compared and
+             * are not part of any baseline.
+             */
+            bool stable = true;
+        };
+
+        PerformanceTestData() = default;
+
+        PerformanceTestData(const PerformanceTestData&) = default;
+
+        PerformanceTestData(PerformanceTestData&&) = default;
+
+        explicit PerformanceTestData(const TestData& other);
+
+        ~PerformanceTestData() noexcept override = default;
+
+        PerformanceTestData& operator=(const PerformanceTestData&) = default;
+
+        PerformanceTestData& operator=(PerformanceTestData&&) = default;
+
+        /**
+         * \brief Get the unique type name.
+         * \return Unique type name.
+         */
+        [[nodiscard]] std::string getType() const override;
+
+        /**
+         * \brief Compare results against the baseline formed by the last options.baselineRuns stable runs with the
+         * same argument, thread count, cache mode and metric, report the comparison and add the results to the
+         * history. Tail latencies are reported relative to the most recent stable run. Results measured in an unfit
+         * environment or on a throttled CPU are flagged and not compared. If options.regressionMetric names a counter
+         * of the results, its rates are compared instead of the times. The history keeps at most options.baselineRuns
+         * stable and options.baselineRuns unstable runs per key.
+         * \param suite TestSuite.
+         * \param results Results of the current run.
+         * \param options Options.
+         * \param out Output.
+         * \return False if the results are a regression.
+         */
+        bool addResults(const TestSuite&        suite,
+                        const BenchmarkResults& results,
+                        const BenchmarkOptions& options,
+                        std::ostream&           out);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Previous runs of all arguments and thread counts, oldest first.
+         */
+        std::vector<Run> history;
+    };
+
+    /**
+     * \brief Find the PerformanceTestData of a performance test.
+     * \param suite TestSuite.
+     * \param name Test name.
+     * \return PerformanceTestData or nullptr.
+     */
+    [[nodiscard]] PerformanceTestData* findPerformanceTestData(const TestSuite& suite, const std::string& name);
+
+    /**
+     * \brief Get the path of the file to which the folded stacks of a performance test are written. Characters that
+     * are not valid in file names are replaced. Creates the output directory if necessary.
+     * \param suite TestSuite.
+     * \param name Test name.
+     * \return Path, or empty if profiling is disabled.
+     */
+    [[nodiscard]] std::optional<std::filesystem::path> getProfilePath(const TestSuite& suite, const std::string& name);
+}  // namespace bt
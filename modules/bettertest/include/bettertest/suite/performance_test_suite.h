@@ -18,11 +18,17 @@
 
 namespace bt
 {
+    class IExporter;
+
+    /**
+     * \brief The PerformanceTestSuite class holds all data and runners for performance tests. Performance tests are
+     * always run serialized.
+     */
     class PerformanceTestSuite
     {
     public:
-        using TestData_t    = std::vector<TestDataPtr>;
-        using TestRunners_t = std::vector<ITestRunnerPtr>;
+        using TestDataList   = std::vector<TestDataPtr>;
+        using TestRunnerList = std::vector<ITestRunnerPtr>;
 
         PerformanceTestSuite() = default;
 
@@ -36,24 +42,131 @@ namespace bt
 
         PerformanceTestSuite& operator=(PerformanceTestSuite&&) = delete;
 
+        ////////////////////////////////////////////////////////////////
+        // Initialization.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Add a performance test runner.
+         * \param runner Performance test runner.
+         */
         void addTest(ITestRunnerPtr runner);
 
+        /**
+         * \brief Set the list of filters that is used to enable or disable specific performance tests.
+         * \param filters List of filter strings.
+         */
         void setFilter(const std::vector<std::string>& filters);
 
-        void setRunFailingOnly(bool run) noexcept;
-
-        [[nodiscard]] TestData_t& getData() noexcept;
-
-        [[nodiscard]] const TestData_t& getData() const noexcept;
-
-        void operator()();
+        /**
+         * \brief If enabled successful tests are skipped and only failing tests are run. New tests are also classified as failing.
+         * \param failingOnly Run failing tests only.
+         */
+        void setRunFailingOnly(bool failingOnly) noexcept;
+
+        /**
+         * \brief If enabled performance tests are not run at all when the environment has errors or warnings, and the
+         * suite fails. Otherwise, warnings are only printed, and results are not compared to previous runs if the
+         * environment has errors.
+         * \param strict Refuse to run in an unfit environment.
+         */
+        void setStrictEnvironment(bool strict) noexcept;
+
+        /**
+         * \brief If enabled the call stacks of performance tests are sampled while measuring and written as folded
+         * stacks to the output directory.
+         * \param enabled Profile tests.
+         */
+        void setProfiling(bool enabled) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get list of TestData objects.
+         * \return TestDataList.
+         */
+        [[nodiscard]] TestDataList& getData() noexcept;
+
+        /**
+         * \brief Get const list of TestData objects.
+         * \return TestDataList.
+         */
+        [[nodiscard]] const TestDataList& getData() const noexcept;
+
+        /**
+         * \brief Returns whether all active tests passed.
+         * \return True or false.
+         */
+        [[nodiscard]] bool isPassing() const noexcept;
+
+        /**
+         * \brief Returns whether performance tests are profiled.
+         * \return True or false.
+         */
+        [[nodiscard]] bool isProfiling() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Run.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Run. The calling thread is pinned to a single CPU while running and the environment is stored in the
+         * suite data.
+         * \param suite TestSuite.
+         * \param exporter Exporter.
+         * \param out Output.
+         */
+        void operator()(const TestSuite& suite, IExporter& exporter, std::ostream& out);
 
     private:
-        void resolveTests();
-
-        TestData_t    data;
-        TestRunners_t runners;
-        NameFilter    filter;
-        bool          runFailingOnly = false;
+        /**
+         * \brief Determine which tests need to run.
+         * \param suite TestSuite.
+         * \param out Output.
+         */
+        void resolveTests(const TestSuite& suite, std::ostream& out);
+
+        void runTests(const TestSuite& suite, IExporter& exporter, std::ostream& out) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief List of all TestData objects.
+         */
+        TestDataList data;
+
+        /**
+         * \brief List of all TestRunner objects.
+         */
+        TestRunnerList runners;
+
+        /**
+         * \brief Filter object.
+         */
+        NameFilter filter;
+
+        /**
+         * \brief Run failing tests only.
+         */
+        bool runFailingOnly = false;
+
+        /**
+         * \brief Refuse to run in an unfit environment.
+         */
+        bool strictEnvironment = false;
+
+        /**
+         * \brief Set if tests were not run because the environment was unfit.
+         */
+        bool refused = false;
+
+        /**
+         * \brief Sample call stacks of tests.
+         */
+        bool profiling = false;
     };
 }  // namespace bt
@@ -12,6 +12,8 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "bettertest/utils/date.h"
+#include "bettertest/utils/environment.h"
 #include "bettertest/utils/version.h"
 
 namespace bt
@@ -73,14 +75,15 @@ namespace bt
         ////////////////////////////////////////////////////////////////
 
         /**
-         * \brief Date and time at which this test suite was created.
+         * \brief Date and time at which this test suite was created. Exporters that write text can format it with
+         * dateTimeAsString.
          */
-        std::string dateCreated;
+        date_time_t dateCreated;
 
         /**
          * \brief Date and time at which this test suite was last run.
          */
-        std::string dateLastRun;
+        date_time_t dateLastRun;
 
         /**
          * \brief Test suite name.
@@ -101,5 +104,10 @@ namespace bt
          * \brief BetterTest version.
          */
         Version version;
+
+        /**
+         * \brief Machine state during the last run of the performance tests.
+         */
+        BenchmarkEnvironment environment;
     };
 }  // namespace bt
@@ -4,15 +4,64 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/date.h"
+
 namespace bt
 {
     class TestData;
     using TestDataPtr = std::unique_ptr<TestData>;
     class TestSuite;
 
+    /**
+     * \brief Reason a test did not pass.
+     */
+    enum class failure_t : uint32_t
+    {
+        /**
+         * \brief The test passed, or has not been run.
+         */
+        none = 0,
+
+        /**
+         * \brief A check failed or the test threw an exception.
+         */
+        failed = 1,
+
+        /**
+         * \brief The process running the test crashed or was terminated.
+         */
+        crashed = 2,
+
+        /**
+         * \brief The test exceeded its memory limit. See ResourceLimits.
+         */
+        memory_limit = 3,
+
+        /**
+         * \brief The test exceeded its CPU time limit. See ResourceLimits.
+         */
+        cpu_limit = 4,
+
+        /**
+         * \brief The test exceeded its open file limit. See ResourceLimits.
+         */
+        file_limit = 5,
+
+        /**
+         * \brief The test exceeded its wall-clock time limit and was killed. See ResourceLimits.
+         */
+        time_limit = 6
+    };
+
     /**
      * \brief The TestData class holds all data describing a specific test.
      */
@@ -74,14 +123,20 @@ namespace bt
         ////////////////////////////////////////////////////////////////
 
         /**
-         * \brief Date and time at which this test was created.
+         * \brief Date and time at which this test was created. Exporters that write text can format it with
+         * dateTimeAsString.
          */
-        std::string dateCreated;
+        date_time_t dateCreated;
 
         /**
          * \brief Date and time at which this test was last run.
          */
-        std::string dateLastRun;
+        date_time_t dateLastRun;
+
+        /**
+         * \brief Duration of the last run of this test.
+         */
+        std::chrono::nanoseconds duration{0};
 
         /**
          * \brief Test name.
@@ -93,6 +148,11 @@ namespace bt
          */
         bool passing = false;
 
+        /**
+         * \brief Reason the last run of this test did not pass.
+         */
+        failure_t failure = failure_t::none;
+
         /**
          * \brief Index of the runner that will execute this test. Left at -1 if the test is not being run.
          */
@@ -0,0 +1,185 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/suite/test_data.h"
+#include "bettertest/utils/date.h"
+
+namespace bt
+{
+    /**
+     * \brief The TestDataStore class holds the records of many tests in columns instead of as separate TestData
+     * objects. Names are interned in a shared table and can be looked up in constant time, and the state of each test
+     * is packed into a few bits, so that resolving, scheduling and summarizing large suites touches little memory. Only
+     * plain TestData can be stored. Suites with TestData subclasses keep using a list of TestData objects.
+     */
+    class TestDataStore
+    {
+    public:
+        TestDataStore() = default;
+
+        TestDataStore(const TestDataStore&) = delete;
+
+        TestDataStore(TestDataStore&&) = default;
+
+        ~TestDataStore() noexcept = default;
+
+        TestDataStore& operator=(const TestDataStore&) = delete;
+
+        TestDataStore& operator=(TestDataStore&&) = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Conversion.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Returns whether all TestData objects in a list can be stored, i.e. none of them is a subclass.
+         * \param list List of TestData.
+         * \return True or false.
+         */
+        [[nodiscard]] static bool canStore(const std::vector<TestDataPtr>& list) noexcept;
+
+        /**
+         * \brief Replace the contents of this store with a list of TestData objects. See canStore.
+         * \param list List of TestData.
+         */
+        void assign(const std::vector<TestDataPtr>& list);
+
+        /**
+         * \brief Create a TestData object for each record, in order.
+         * \return List of TestData.
+         */
+        [[nodiscard]] std::vector<TestDataPtr> toTestData() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Records.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Find the record of a test.
+         * \param name Test name.
+         * \return Record index, or empty if there is none.
+         */
+        [[nodiscard]] std::optional<size_t> find(std::string_view name) const;
+
+        /**
+         * \brief Add a record for a test that has not been run before. See TestData::create.
+         * \param name Test name. Must not be in the store yet.
+         * \param date Date and time of creation.
+         * \return Record index.
+         */
+        size_t add(std::string_view name, date_time_t date);
+
+        /**
+         * \brief Prepare a record for running. See TestData::initialize.
+         * \param index Record index.
+         * \param runner Index of the runner that will execute the test.
+         * \param time Date and time of the run.
+         */
+        void initialize(size_t index, size_t runner, date_time_t time) noexcept;
+
+        /**
+         * \brief Store the result of running a test. See TestData::finalize. Safe to call concurrently for different
+         * records.
+         * \param index Record index.
+         * \param pass Passing state of the test.
+         * \param duration Duration of the run.
+         * \param failure Reason the test did not pass.
+         */
+        void finalize(size_t index, bool pass, std::chrono::nanoseconds duration, failure_t failure) noexcept;
+
+        /**
+         * \brief Remove all records.
+         */
+        void clear() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t size() const noexcept { return names.size(); }
+
+        [[nodiscard]] bool empty() const noexcept { return names.empty(); }
+
+        [[nodiscard]] std::string_view getName(const size_t index) const noexcept { return names[index]; }
+
+        [[nodiscard]] bool isPassing(const size_t index) const noexcept { return flags[index] & passing; }
+
+        [[nodiscard]] bool hasRunnerIndex(const size_t index) const noexcept { return flags[index] & active; }
+
+        [[nodiscard]] size_t getRunnerIndex(const size_t index) const noexcept { return runners[index]; }
+
+        [[nodiscard]] date_time_t getDateCreated(const size_t index) const noexcept { return created[index]; }
+
+        [[nodiscard]] date_time_t getDateLastRun(const size_t index) const noexcept { return lastRun[index]; }
+
+        [[nodiscard]] std::chrono::nanoseconds getDuration(const size_t index) const noexcept
+        {
+            return durations[index];
+        }
+
+        [[nodiscard]] failure_t getFailure(const size_t index) const noexcept { return failures[index]; }
+
+        /**
+         * \brief Returns whether all tests that have a runner passed.
+         * \return True or false.
+         */
+        [[nodiscard]] bool allPassing() const noexcept;
+
+    private:
+        /**
+         * \brief Bits of the flags column.
+         */
+        enum flag_t : uint8_t
+        {
+            passing = 1,
+            active  = 2
+        };
+
+        /**
+         * \brief Copy a name into the name table.
+         * \param name Name.
+         * \return View of the interned name, which stays valid until the store is cleared.
+         */
+        [[nodiscard]] std::string_view intern(std::string_view name);
+
+        /**
+         * \brief Blocks of the name table. Blocks are never reallocated, so views of names stay valid.
+         */
+        std::vector<std::unique_ptr<char[]>> blocks;
+
+        size_t blockUsed = 0;
+
+        size_t blockSize = 0;
+
+        std::unordered_map<std::string_view, uint32_t> lookup;
+
+        std::vector<std::string_view> names;
+
+        std::vector<uint8_t> flags;
+
+        std::vector<uint32_t> runners;
+
+        std::vector<date_time_t> created;
+
+        std::vector<date_time_t> lastRun;
+
+        std::vector<std::chrono::nanoseconds> durations;
+
+        std::vector<failure_t> failures;
+    };
+}  // namespace bt
@@ -17,6 +17,7 @@
 #include "bettertest/runners/test_runner_interface.h"
 #include "bettertest/suite/performance_test_suite.h"
 #include "bettertest/suite/unit_test_suite.h"
+#include "bettertest/utils/trace.h"
 
 namespace bt
 {
@@ -113,6 +114,50 @@ namespace bt
          */
         void setMultithreaded(bool multiThreaded);
 
+        /**
+         * \brief If enabled each unit test runs in a child process with the resource limits of the suite or test.
+         * \param isolate Run unit tests in isolated processes.
+         */
+        void setIsolated(bool isolate);
+
+        /**
+         * \brief Set the default resource limits of unit tests that run in isolated processes.
+         * \param limits Resource limits.
+         */
+        void setResourceLimits(const ResourceLimits& limits);
+
+        /**
+         * \brief Run unit tests that can run in parallel in a pool of worker processes. See UnitTestSuite::setWorkers.
+         * \param count Number of worker processes. 0 to disable the pool.
+         * \param command Command line arguments of this process, including the program name.
+         */
+        void setWorkers(size_t count, std::vector<std::string> command);
+
+        /**
+         * \brief Run as a worker process of a pool instead of running the suite. Only unit tests sent by the
+         * coordinator are run. The coordinator imports and exports the suite.
+         * \param socket Socket of the coordinator.
+         */
+        void setWorkerSocket(std::filesystem::path socket);
+
+        /**
+         * \brief If enabled performance tests are not run when the environment has errors or warnings.
+         * \param strict Refuse to run in an unfit environment.
+         */
+        void setStrictEnvironment(bool strict);
+
+        /**
+         * \brief If enabled the call stacks of performance tests are sampled and written to the output directory.
+         * \param enabled Profile performance tests.
+         */
+        void setProfiling(bool enabled);
+
+        /**
+         * \brief Set the file to which a trace of all suite phases and tests is written when the suite finishes.
+         * \param file Trace file, or empty to disable tracing.
+         */
+        void setTraceFile(std::filesystem::path file);
+
         ////////////////////////////////////////////////////////////////
         // Getters.
         ////////////////////////////////////////////////////////////////
@@ -123,12 +168,24 @@ namespace bt
          */
         [[nodiscard]] const std::string& getName() const noexcept;
 
+        /**
+         * \brief Get output directory.
+         * \return Output directory.
+         */
+        [[nodiscard]] const std::filesystem::path& getOutputDirectory() const noexcept;
+
         /**
          * \brief Get suite data.
          * \return SuiteData.
          */
         [[nodiscard]] SuiteData& getData() const noexcept;
 
+        /**
+         * \brief Get the tracer that records suite phases and tests.
+         * \return Tracer, or nullptr if tracing is disabled.
+         */
+        [[nodiscard]] Tracer* getTracer() const noexcept;
+
         /**
          * \brief Get const unit test suite.
          * \return UnitTestSuite.
@@ -167,6 +224,11 @@ namespace bt
         ////////////////////////////////////////////////////////////////
 
     private:
+        /**
+         * \brief Run unit tests sent by the coordinator until it has no more tests.
+         */
+        void runWorker();
+
         /**
          * \brief Suite name.
          */
@@ -182,6 +244,21 @@ namespace bt
          */
         std::unique_ptr<SuiteData> data;
 
+        /**
+         * \brief Trace file.
+         */
+        std::filesystem::path traceFile;
+
+        /**
+         * \brief Tracer, or nullptr if tracing is disabled.
+         */
+        std::unique_ptr<Tracer> tracer;
+
+        /**
+         * \brief Socket of the coordinator if this process is a worker.
+         */
+        std::filesystem::path workerSocket;
+
         /**
          * \brief Function to create an importer.
          */
@@ -4,8 +4,12 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <chrono>
 #include <filesystem>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////
@@ -14,6 +18,8 @@
 
 #include "bettertest/runners/unit_test_runner.h"
 #include "bettertest/suite/test_data.h"
+#include "bettertest/suite/test_data_store.h"
+#include "bettertest/utils/isolation.h"
 #include "bettertest/utils/name_filter.h"
 
 namespace bt
@@ -69,21 +75,61 @@ namespace bt
          */
         void setMultithreaded(bool multiThread);
 
+        /**
+         * \brief If enabled each test runs in a child process, so that a crash or exceeded resource limit of a test
+         * does not affect the others. The exporter writes the results of a test from its child process. Only supported
+         * on Linux. Elsewhere tests keep running in this process without limits.
+         * \param isolate Run tests in isolated processes.
+         */
+        void setIsolated(bool isolate) noexcept;
+
+        /**
+         * \brief Set the resource limits of tests that run in isolated processes. Tests can override each limit.
+         * \param resourceLimits Resource limits.
+         */
+        void setResourceLimits(const ResourceLimits& resourceLimits) noexcept;
+
+        /**
+         * \brief Run tests that can run in parallel in a pool of worker processes instead of threads. Workers run the
+         * same executable with an additional --worker argument, connect back over a Unix domain socket and pull tests
+         * in batches. Only supported on Linux.
+         * \param count Number of worker processes. 0 to disable the pool.
+         * \param command Command line arguments of this process, including the program name.
+         */
+        void setWorkers(size_t count, std::vector<std::string> command);
+
         ////////////////////////////////////////////////////////////////
         // Getters.
         ////////////////////////////////////////////////////////////////
 
         /**
-         * \brief Get list of TestData objects.
+         * \brief Get list of TestData objects. If the records are held by the store, they are moved back into the list,
+         * which is then used until the next run.
          * \return TestDataList.
          */
-        [[nodiscard]] TestDataList& getData() noexcept;
+        [[nodiscard]] TestDataList& getData();
 
         /**
-         * \brief Get const list of TestData objects.
+         * \brief Get const list of TestData objects. If the records are held by the store, TestData objects are created
+         * once per run, on the first call. Calls during a run return the same list, so that exporters on different
+         * threads can read it safely, and the list is created again on the first call after the run. Exporters of large
+         * suites should read the store directly instead.
          * \return TestDataList.
          */
-        [[nodiscard]] const TestDataList& getData() const noexcept;
+        [[nodiscard]] const TestDataList& getData() const;
+
+        /**
+         * \brief Returns whether the records of all tests are held by the store instead of the list of TestData
+         * objects. This is the case after running if none of them is a TestData subclass.
+         * \return True or false.
+         */
+        [[nodiscard]] bool isColumnar() const noexcept;
+
+        /**
+         * \brief Get the columnar store of test records. Empty if isColumnar is false.
+         * \return TestDataStore.
+         */
+        [[nodiscard]] const TestDataStore& getStore() const noexcept;
 
         /**
          * \brief Returns whether all active tests passed.
@@ -103,26 +149,92 @@ namespace bt
          */
         void operator()(const TestSuite& suite, IExporter& exporter, std::ostream& out);
 
-    private:
         /**
-         * \brief Determine which tests need to run.
+         * \brief Determine which tests need to run. Called by operator(), but can be called separately to inspect the
+         * resolved TestData without running any tests.
          * \param suite TestSuite.
          * \param out Output.
          */
         void resolveTests(const TestSuite& suite, std::ostream& out);
 
-        void runTestsSerialized(const TestSuite& suite, IExporter& exporter, std::ostream& out) const;
+        /**
+         * \brief Run as a worker process of a pool. Connects to the coordinator, then runs the tests it is sent and
+         * sends back their results until the coordinator has no more tests. See setWorkers.
+         * \param suite TestSuite.
+         * \param exporter Exporter.
+         * \param socket Socket of the coordinator.
+         * \return True if all tests sent by the coordinator were run.
+         */
+        [[nodiscard]] bool runWorker(const TestSuite& suite, IExporter& exporter, const std::filesystem::path& socket);
+
+    private:
+        void resolveTestsColumnar(std::ostream& out);
+
+        void resolveTestsList(const TestSuite& suite, std::ostream& out);
+
+        void runTestsSerialized(const TestSuite& suite, IExporter& exporter, std::ostream& out);
+
+        void runTestsMultithreaded(const TestSuite& suite, IExporter& exporter, std::ostream& out);
+
+        void runTestsOnWorkers(const TestSuite& suite, IExporter& exporter, std::ostream& out);
+
+        /**
+         * \brief Run a test, in an isolated process if enabled.
+         * \param suite TestSuite.
+         * \param exporter Exporter.
+         * \param runner Runner of the test.
+         * \param out Output of the test.
+         * \return Passing state, error message and reason the test did not pass.
+         */
+        [[nodiscard]] std::tuple<bool, std::string, failure_t>
+          runTest(const TestSuite& suite, IExporter& exporter, ITestRunner& runner, std::ostream& out) const;
+
+        /**
+         * \brief Get the index of the runner of a test.
+         * \param test Index of the test in the store or list.
+         * \return Runner index, or empty if the test is not run.
+         */
+        [[nodiscard]] std::optional<size_t> getRunnerIndex(size_t test) const noexcept;
 
-        void runTestsMultithreaded(const TestSuite& suite, IExporter& exporter, std::ostream& out) const;
+        /**
+         * \brief Store the result of a test. Safe to call concurrently for different tests.
+         * \param suite TestSuite.
+         * \param test Index of the test in the store or list.
+         * \param pass Passing state.
+         * \param duration Duration of the run.
+         * \param failure Reason the test did not pass.
+         */
+        void finalizeTest(
+          const TestSuite& suite, size_t test, bool pass, std::chrono::nanoseconds duration, failure_t failure);
 
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
 
         /**
-         * \brief List of all TestData objects.
+         * \brief List of all TestData objects. Created from the store on demand if the store is used.
+         */
+        mutable TestDataList data;
+
+        /**
+         * \brief Columnar records of all tests, used instead of the list if it contains no TestData subclasses.
+         */
+        TestDataStore store;
+
+        /**
+         * \brief Whether the store holds the records instead of the list.
+         */
+        bool columnar = false;
+
+        /**
+         * \brief Whether the list was created from the current contents of the store.
          */
-        TestDataList data;
+        mutable bool materialized = false;
+
+        /**
+         * \brief Guards creating the list from the store against other readers and against tests being finalized.
+         */
+        mutable std::mutex dataMutex;
 
         /**
          * \brief List of all TestRunner objects.
@@ -140,5 +252,25 @@ namespace bt
         bool runFailingOnly = false;
 
         bool multiThreaded = false;
+
+        /**
+         * \brief Run each test in a child process.
+         */
+        bool isolated = false;
+
+        /**
+         * \brief Default resource limits of isolated tests.
+         */
+        ResourceLimits limits;
+
+        /**
+         * \brief Number of worker processes. 0 if tests are not run on workers.
+         */
+        size_t workerCount = 0;
+
+        /**
+         * \brief Command line arguments used to start worker processes.
+         */
+        std::vector<std::string> workerCommand;
     };
 }  // namespace bt
@@ -4,19 +4,29 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <array>
 #include <concepts>
+#include <ostream>
+#include <span>
+#include <string_view>
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
 #include "bettertest/mixins/mixin_interface.h"
-#include "bettertest/tests/test_interface.h"
+#include "bettertest/mixins/mixin_results_getter.h"
+#include "bettertest/tests/performance_test_interface.h"
+#include "bettertest/utils/optimizer_barrier.h"
 
 namespace bt
 {
+    /**
+     * \brief Base class of performance tests. The call operator is the measured code and is invoked many times. Test
+     * state that must persist between iterations can be stored in member variables.
+     */
     template<typename Derived, std::derived_from<IMixin>... Mixins>
-    class PerformanceTest : public ITest, public virtual Mixins...
+    class PerformanceTest : public IPerformanceTest, public Mixins...
     {
     public:
         static constexpr bool isPerformanceTest = true;
@@ -33,7 +43,42 @@ namespace bt
 
         PerformanceTest& operator=(PerformanceTest&&) = delete;
 
-        [[nodiscard]] bool passing() const noexcept override { return (true && ... && Mixins::template isPassing()); }
+        void setOutput(std::ostream& output) { (..., Mixins::setOutput(output)); }
+
+        void setConcurrentRecording([[maybe_unused]] const bool concurrent)
+        {
+            (..., Mixins::setConcurrentRecording(concurrent));
+        }
+
+        void beginTest() { (..., Mixins::beginTest()); }
+
+        void endTest() { (..., Mixins::endTest()); }
+
+        [[nodiscard]] std::span<const std::string_view> getMixins() const noexcept override { return mixinTypes; }
+
+        [[nodiscard]] MixinResultsView getResultsGetters() const noexcept override
+        {
+            return MixinResultsView(mixinGetters, MixinResultsGetter{this});
+        }
+
+        [[nodiscard]] bool passing() const noexcept override { return (true && ... && Mixins::isPassing()); }
+
+    private:
+        template<typename M>
+        [[nodiscard]] static const IMixin& getMixin(const ITest& test) noexcept
+        {
+            return static_cast<const M&>(static_cast<const PerformanceTest&>(test));
+        }
+
+        /**
+         * \brief Unique type names of all mixins. Shared by all instances.
+         */
+        static constexpr std::array<std::string_view, sizeof...(Mixins)> mixinTypes = {Mixins::type...};
+
+        /**
+         * \brief Getters for all mixins. Shared by all instances.
+         */
+        static constexpr std::array<mixin_getter_t, sizeof...(Mixins)> mixinGetters = {&getMixin<Mixins>...};
     };
 
     template<typename T>
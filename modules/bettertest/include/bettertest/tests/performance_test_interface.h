@@ -0,0 +1,226 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/mixins/mixin_results_getter.h"
+#include "bettertest/tests/test_interface.h"
+#include "bettertest/utils/benchmark.h"
+#include "bettertest/utils/cache.h"
+#include "bettertest/utils/complexity.h"
+
+namespace bt
+{
+    class IPerformanceTest : public ITest
+    {
+    public:
+        IPerformanceTest() = default;
+
+        IPerformanceTest(const IPerformanceTest&) = delete;
+
+        IPerformanceTest(IPerformanceTest&&) = delete;
+
+        ~IPerformanceTest() noexcept override = default;
+
+        IPerformanceTest& operator=(const IPerformanceTest&) = delete;
+
+        IPerformanceTest& operator=(IPerformanceTest&&) = delete;
+
+        /**
+         * \brief Get the unique type names of all mixins of this test.
+         * \return List of type names.
+         */
+        [[nodiscard]] virtual std::span<const std::string_view> getMixins() const noexcept = 0;
+
+        /**
+         * \brief Get a view over all mixins of this test, in the same order as getMixins.
+         * \return View of const IMixin pointers.
+         */
+        [[nodiscard]] virtual MixinResultsView getResultsGetters() const noexcept = 0;
+
+        /**
+         * \brief Called before measuring each argument and thread count, after both were set. Override to prepare state
+         * that depends on them, e.g. to fill a container of the requested size.
+         */
+        virtual void setUp() {}
+
+        /**
+         * \brief Called before each repetition, outside of the measured time. With multiple threads, called by each
+         * thread.
+         */
+        virtual void setUpRepetition() {}
+
+        /**
+         * \brief Called after each repetition, outside of the measured time. With multiple threads, called by each
+         * thread.
+         */
+        virtual void tearDownRepetition() {}
+
+        /**
+         * \brief Called before each iteration, outside of the measured time. Override to regenerate input that the
+         * call operator consumes, e.g. to shuffle a vector before sorting it. Timing is paused around the call, and the
+         * overhead of pausing is compensated for. Tests that do not override this are not paused.
+         */
+        virtual void setUpIteration() {}
+
+        /**
+         * \brief Called after each iteration, outside of the measured time. Timing is paused like for setUpIteration.
+         */
+        virtual void tearDownIteration() {}
+
+        /**
+         * \brief Called before each iteration measured with cold caches, outside of the measured time. Evicts all
+         * caches by default. Override to flush only the data used by the test, e.g. with CacheEvictor::flush, which is
+         * much faster.
+         * \param evictor CacheEvictor.
+         */
+        virtual void evictCaches(const CacheEvictor& evictor) { evictor.evict(); }
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the argument that is currently being measured. 0 for tests without arguments.
+         * \return Argument.
+         */
+        [[nodiscard]] int64_t getArgument() const noexcept { return argument; }
+
+        /**
+         * \brief Get the number of threads that concurrently call the test. 1 for tests without thread counts.
+         * \return Thread count.
+         */
+        [[nodiscard]] size_t getThreadCount() const noexcept { return threadCount; }
+
+        /**
+         * \brief Get the index of the calling thread, e.g. to select per-thread state in the call operator.
+         * \return Index in [0, getThreadCount()).
+         */
+        [[nodiscard]] static size_t getThreadIndex() noexcept { return getBenchmarkThreadIndex(); }
+
+        ////////////////////////////////////////////////////////////////
+        // Timing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Stop counting time for the calling thread, e.g. to prepare data in the middle of an iteration. Must be
+         * followed by a call to resumeTiming. The overhead of pausing is compensated for.
+         */
+        static void pauseTiming() noexcept { bt::pauseTiming(); }
+
+        /**
+         * \brief Resume counting time for the calling thread.
+         */
+        static void resumeTiming() noexcept { bt::resumeTiming(); }
+
+        /**
+         * \brief Get the quantities processed per iteration, as set with setBytesProcessed, setItemsProcessed and
+         * setCounter.
+         * \return List of Counters.
+         */
+        [[nodiscard]] const std::vector<Counter>& getCounters() const noexcept { return counters; }
+
+        /**
+         * \brief Get the measured results of this test, one for each argument and thread count.
+         * \return List of BenchmarkResults.
+         */
+        [[nodiscard]] const std::vector<BenchmarkResults>& getBenchmarkResults() const noexcept
+        {
+            return benchmarkResults;
+        }
+
+        /**
+         * \brief Get the complexity fitted to the results of all arguments at the smallest thread count. Empty for
+         * tests without arguments.
+         * \return ComplexityFit.
+         */
+        [[nodiscard]] const std::optional<ComplexityFit>& getComplexityFit() const noexcept { return complexityFit; }
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the argument that is measured next. Called by the PerformanceTestRunner.
+         * \param arg Argument.
+         */
+        void setArgument(const int64_t arg) noexcept { argument = arg; }
+
+        /**
+         * \brief Set the number of threads that is measured next. Called by the PerformanceTestRunner.
+         * \param count Thread count.
+         */
+        void setThreadCount(const size_t count) noexcept { threadCount = count; }
+
+        /**
+         * \brief Set the number of bytes processed by each iteration, e.g. in setUp after the argument was set.
+         * Reported as bytes per second.
+         * \param perIteration Bytes per iteration and thread.
+         */
+        void setBytesProcessed(const double perIteration) { setCounter("bytes", perIteration); }
+
+        /**
+         * \brief Set the number of items processed by each iteration. Reported as items per second.
+         * \param perIteration Items per iteration and thread.
+         */
+        void setItemsProcessed(const double perIteration) { setCounter("items", perIteration); }
+
+        /**
+         * \brief Set a named quantity processed by each iteration, e.g. "requests". Reported as a rate per second.
+         * Replaces the previous value of a counter with the same name.
+         * \param name Counter name.
+         * \param perIteration Quantity per iteration and thread.
+         */
+        void setCounter(std::string name, const double perIteration)
+        {
+            if (const auto it = std::ranges::find(counters, name, &Counter::name); it != counters.end())
+                it->perIteration = perIteration;
+            else
+                counters.emplace_back(std::move(name), perIteration);
+        }
+
+        /**
+         * \brief Add the measured results of an argument and thread count. Called by the PerformanceTestRunner.
+         * \param results BenchmarkResults.
+         */
+        void addBenchmarkResults(BenchmarkResults results) { benchmarkResults.emplace_back(std::move(results)); }
+
+        /**
+         * \brief Set the complexity fitted to the results. Called by the PerformanceTestRunner.
+         * \param fit ComplexityFit.
+         */
+        void setComplexityFit(const ComplexityFit& fit) noexcept { complexityFit = fit; }
+
+    private:
+        int64_t argument = 0;
+
+        size_t threadCount = 1;
+
+        std::vector<Counter> counters;
+
+        std::vector<BenchmarkResults> benchmarkResults;
+
+        std::optional<ComplexityFit> complexityFit;
+    };
+
+    template<typename T>
+    concept IsIPerformanceTest = std::derived_from<T, IPerformanceTest>;
+
+    using IPerformanceTestPtr = std::unique_ptr<IPerformanceTest>;
+}  // namespace bt
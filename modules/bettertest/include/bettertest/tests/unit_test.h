@@ -4,10 +4,11 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <array>
 #include <concepts>
 #include <ostream>
-#include <string>
-#include <vector>
+#include <span>
+#include <string_view>
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
@@ -25,11 +26,7 @@ namespace bt
     public:
         static constexpr bool isUnitTest = true;
 
-        UnitTest()
-        {
-            (..., mixins.emplace_back(static_cast<Mixins&>(*this).getType()));
-            (..., getters.emplace_back(std::make_unique<MixinResultsGetter<Mixins>>(*this)));
-        }
+        UnitTest() = default;
 
         UnitTest(const UnitTest&) = delete;
 
@@ -43,18 +40,37 @@ namespace bt
 
         void setOutput(std::ostream& output) { (..., Mixins::setOutput(output)); }
 
-        [[nodiscard]] const std::vector<std::string>& getMixins() const noexcept override { return mixins; }
+        void setConcurrentRecording(const bool concurrent) { (..., Mixins::setConcurrentRecording(concurrent)); }
+
+        void beginTest() { (..., Mixins::beginTest()); }
+
+        void endTest() { (..., Mixins::endTest()); }
+
+        [[nodiscard]] std::span<const std::string_view> getMixins() const noexcept override { return mixinTypes; }
 
-        [[nodiscard]] const std::vector<IMixinResultsGetterPtr>& getResultsGetters() const noexcept override
+        [[nodiscard]] MixinResultsView getResultsGetters() const noexcept override
         {
-            return getters;
+            return MixinResultsView(mixinGetters, MixinResultsGetter{this});
         }
 
         [[nodiscard]] bool passing() const noexcept override { return (true && ... && Mixins::isPassing()); }
 
     private:
-        std::vector<std::string>            mixins;
-        std::vector<IMixinResultsGetterPtr> getters;
+        template<typename M>
+        [[nodiscard]] static const IMixin& getMixin(const ITest& test) noexcept
+        {
+            return static_cast<const M&>(static_cast<const UnitTest&>(test));
+        }
+
+        /**
+         * \brief Unique type names of all mixins. Shared by all instances.
+         */
+        static constexpr std::array<std::string_view, sizeof...(Mixins)> mixinTypes = {Mixins::type...};
+
+        /**
+         * \brief Getters for all mixins. Shared by all instances.
+         */
+        static constexpr std::array<mixin_getter_t, sizeof...(Mixins)> mixinGetters = {&getMixin<Mixins>...};
     };
 
     template<typename T>
@@ -6,6 +6,8 @@
 
 #include <concepts>
 #include <memory>
+#include <span>
+#include <string_view>
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
@@ -31,9 +33,17 @@ namespace bt
 
         IUnitTest& operator=(IUnitTest&&) = delete;
 
-        [[nodiscard]] virtual const std::vector<std::string>& getMixins() const noexcept = 0;
-
-        [[nodiscard]] virtual const std::vector<IMixinResultsGetterPtr>& getResultsGetters() const noexcept = 0;
+        /**
+         * \brief Get the unique type names of all mixins of this test.
+         * \return List of type names.
+         */
+        [[nodiscard]] virtual std::span<const std::string_view> getMixins() const noexcept = 0;
+
+        /**
+         * \brief Get a view over all mixins of this test, in the same order as getMixins.
+         * \return View of const IMixin pointers.
+         */
+        [[nodiscard]] virtual MixinResultsView getResultsGetters() const noexcept = 0;
     };
 
     template<typename T>
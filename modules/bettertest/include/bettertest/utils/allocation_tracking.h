@@ -0,0 +1,81 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bt
+{
+    /**
+     * \brief Allocations performed on a single thread while an AllocationScope was active.
+     */
+    struct AllocationStats
+    {
+        /**
+         * \brief Number of calls to operator new.
+         */
+        size_t allocations = 0;
+
+        /**
+         * \brief Number of calls to operator delete.
+         */
+        size_t deallocations = 0;
+
+        /**
+         * \brief Total number of requested bytes.
+         */
+        size_t bytes = 0;
+
+        /**
+         * \brief Highest number of live bytes above the number of live bytes at the start of the scope.
+         */
+        size_t peakLiveBytes = 0;
+    };
+
+    /**
+     * \brief Returns whether global operator new and delete were replaced to track allocations, i.e. whether the
+     * library was built with the BETTERTEST_REPLACE_GLOBAL_NEW CMake option. If not, all AllocationStats are zero. On
+     * MSVC the replacement only applies to the module it is linked into: if bettertest is built as a DLL, allocations
+     * of the test executable and of other DLLs are not seen, so link bettertest statically to track them.
+     * \return True or false.
+     */
+    [[nodiscard]] bool isAllocationTrackingAvailable() noexcept;
+
+    /**
+     * \brief While an AllocationScope exists, all calls to operator new and delete on the thread that created it are
+     * counted. Counters are thread local, so tracking does not take any locks. Scopes can be nested. A scope must be
+     * destroyed on the thread that created it.
+     */
+    class AllocationScope
+    {
+    public:
+        AllocationScope() noexcept;
+
+        AllocationScope(const AllocationScope&) = delete;
+
+        AllocationScope(AllocationScope&&) = delete;
+
+        ~AllocationScope() noexcept;
+
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+        AllocationScope& operator=(AllocationScope&&) = delete;
+
+        /**
+         * \brief Get the allocations performed since this scope was created.
+         * \return AllocationStats.
+         */
+        [[nodiscard]] AllocationStats getStats() const noexcept;
+
+    private:
+        bool     wasActive;
+        uint64_t allocations;
+        uint64_t deallocations;
+        uint64_t bytes;
+        int64_t  liveBytes;
+        int64_t  peakLiveBytes;
+    };
+}  // namespace bt
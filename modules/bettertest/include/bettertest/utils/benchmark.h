@@ -0,0 +1,486 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/cache.h"
+#include "bettertest/utils/complexity.h"
+#include "bettertest/utils/histogram.h"
+#include "bettertest/utils/timer.h"
+
+namespace bt
+{
+    /**
+     * \brief Options controlling how a performance test is measured. A performance test can override the defaults by
+     * declaring a static constexpr BenchmarkOptions options member.
+     */
+    struct BenchmarkOptions
+    {
+        /**
+         * \brief Minimum time spent running the test before measuring starts. Warming up also stops after five times
+         * this duration of wall-clock time, including paused sections.
+         */
+        std::chrono::nanoseconds warmupTime = std::chrono::milliseconds(100);
+
+        /**
+         * \brief Target duration of a single repetition. The number of iterations per repetition is calibrated so that
+         * a repetition takes at least this long, or five times this long in wall-clock time, including paused
+         * sections.
+         */
+        std::chrono::nanoseconds minTime = std::chrono::milliseconds(50);
+
+        /**
+         * \brief Number of measured repetitions.
+         */
+        size_t repetitions = 10;
+
+        /**
+         * \brief Upper bound on the number of iterations per repetition.
+         */
+        uint64_t maxIterations = 1'000'000'000;
+
+        /**
+         * \brief Number of previous runs whose samples form the baseline that new results are compared against.
+         */
+        size_t baselineRuns = 5;
+
+        /**
+         * \brief Significance level of the one-sided Mann-Whitney U test that detects regressions.
+         */
+        double significance = 0.01;
+
+        /**
+         * \brief Minimum relative increase of the median over the baseline median that is considered a regression.
+         * Statistically significant changes below this threshold are ignored.
+         */
+        double regressionThreshold = 0.05;
+
+        /**
+         * \brief Minimum parallel efficiency of a thread count sweep, i.e. the throughput per thread relative to that
+         * of the smallest thread count. A thread count with a lower efficiency fails the test. 0 disables the check.
+         */
+        double minEfficiency = 0;
+
+        /**
+         * \brief Maximum number of individually timed iterations that are recorded in the latency histogram after
+         * measuring. 0 disables the histogram.
+         */
+        uint64_t latencySamples = 100'000;
+
+        /**
+         * \brief Number of significant decimal digits of the latency histogram.
+         */
+        uint32_t latencyDigits = 3;
+
+        /**
+         * \brief Whether the test is measured with warm caches, cold caches, or both.
+         */
+        cache_mode_t cacheMode = cache_mode_t::warm;
+
+        /**
+         * \brief Upper bound on the number of iterations per repetition with cold caches. Evicting caches usually takes
+         * much longer than an iteration, so cold measurements use fewer iterations.
+         */
+        uint64_t coldIterations = 100;
+
+        /**
+         * \brief Name of the counter whose rate is compared against previous runs to detect regressions, e.g. "bytes".
+         * Empty to compare the time per iteration.
+         */
+        std::string_view regressionMetric = {};
+    };
+
+    /**
+     * \brief Quantity processed by each iteration of a performance test, reported as a rate. The counters "bytes" and
+     * "items" are set with IPerformanceTest::setBytesProcessed and setItemsProcessed, others with setCounter.
+     */
+    struct Counter
+    {
+        std::string name;
+
+        double perIteration = 0;
+    };
+
+    /**
+     * \brief Rates of a Counter.
+     */
+    struct CounterResults
+    {
+        std::string name;
+
+        double perIteration = 0;
+
+        /**
+         * \brief Rate per second of each repetition, aggregated over all threads.
+         */
+        std::vector<double> rates;
+
+        /**
+         * \brief Median rate per second.
+         */
+        double rate = 0;
+    };
+
+    /**
+     * \brief Placeholder for the number of hardware threads in the threads member of a performance test, e.g.
+     * ArgumentRange::geometric(1, hardwareThreads, 2) sweeps 1, 2, 4, ... up to the number of hardware threads.
+     */
+    inline constexpr int64_t hardwareThreads = -1;
+
+    /**
+     * \brief Summary statistics of a list of samples.
+     */
+    struct BenchmarkStatistics
+    {
+        double min    = 0;
+        double median = 0;
+        double mean   = 0;
+        double stddev = 0;
+
+        /**
+         * \brief Median absolute deviation from the median. Unlike stddev, this is not affected by a few outliers.
+         */
+        double mad = 0;
+
+        /**
+         * \brief Coefficient of variation, i.e. stddev relative to the mean.
+         */
+        double cv = 0;
+    };
+
+    /**
+     * \brief Range of arguments over which a performance test is swept. A performance test can declare a static
+     * constexpr arguments member that is either an ArgumentRange or an array of integers.
+     */
+    struct ArgumentRange
+    {
+        enum class type_t : uint32_t
+        {
+            linear    = 0,
+            geometric = 1
+        };
+
+        /**
+         * \brief Create the range first, first + step, first + 2 * step, ..., last.
+         */
+        [[nodiscard]] static constexpr ArgumentRange linear(const int64_t first, const int64_t last, const int64_t step)
+        {
+            return {type_t::linear, first, last, step};
+        }
+
+        /**
+         * \brief Create the range first, first * factor, first * factor^2, ..., last.
+         */
+        [[nodiscard]] static constexpr ArgumentRange
+          geometric(const int64_t first, const int64_t last, const int64_t factor)
+        {
+            return {type_t::geometric, first, last, factor};
+        }
+
+        /**
+         * \brief Get all arguments in this range. The last value is always included.
+         * \return List of arguments.
+         */
+        [[nodiscard]] std::vector<int64_t> expand() const;
+
+        type_t  type  = type_t::linear;
+        int64_t first = 0;
+        int64_t last  = 0;
+
+        /**
+         * \brief Step of a linear range, or factor of a geometric range.
+         */
+        int64_t step = 1;
+    };
+
+    /**
+     * \brief Distribution of the times of individual iterations, in nanoseconds.
+     */
+    struct LatencyDistribution
+    {
+        /**
+         * \brief Number of recorded iterations.
+         */
+        uint64_t count = 0;
+
+        double p50   = 0;
+        double p90   = 0;
+        double p99   = 0;
+        double p999  = 0;
+        double p9999 = 0;
+        double max   = 0;
+
+        /**
+         * \brief Histogram encoded with Histogram::encode.
+         */
+        std::string histogram;
+    };
+
+    /**
+     * \brief Results of a performance test for a single argument and thread count. All times are in nanoseconds per
+     * iteration. With multiple threads, each thread runs all iterations and the time of the slowest thread is used.
+     */
+    struct BenchmarkResults
+    {
+        /**
+         * \brief Argument with which the test was run. 0 for tests without arguments.
+         */
+        int64_t argument = 0;
+
+        /**
+         * \brief Number of threads that concurrently ran the test.
+         */
+        size_t threads = 1;
+
+        /**
+         * \brief Cache state in which the test was measured. Either warm or cold.
+         */
+        cache_mode_t cache = cache_mode_t::warm;
+
+        /**
+         * \brief Number of iterations per repetition.
+         */
+        uint64_t iterations = 0;
+
+        /**
+         * \brief Time per iteration of each repetition.
+         */
+        std::vector<double> samples;
+
+        BenchmarkStatistics statistics;
+
+        /**
+         * \brief Aggregate number of iterations per second of all threads, based on the median.
+         */
+        double throughput = 0;
+
+        /**
+         * \brief Mean time per iteration of the individual threads.
+         */
+        double latency = 0;
+
+        /**
+         * \brief Throughput per thread relative to that of the smallest thread count. Only set for thread count
+         * sweeps.
+         */
+        std::optional<double> efficiency;
+
+        /**
+         * \brief Distribution of the times of individual iterations. Empty if disabled.
+         */
+        std::optional<LatencyDistribution> distribution;
+
+        /**
+         * \brief Rates of all counters of the test.
+         */
+        std::vector<CounterResults> counters;
+
+        /**
+         * \brief Whether the CPU was thermally throttled while measuring.
+         */
+        bool throttled = false;
+    };
+
+    /**
+     * \brief Function that runs a number of iterations and returns the elapsed time. With multiple threads, it is
+     * invoked concurrently by all threads.
+     */
+    using batch_function_t = std::function<std::chrono::nanoseconds(uint64_t)>;
+
+    /**
+     * \brief Function that runs a number of iterations and records the time of each iteration in a histogram. With
+     * multiple threads, it is invoked concurrently by all threads, each with its own histogram.
+     */
+    using sample_function_t = std::function<void(uint64_t, Histogram&)>;
+
+    namespace internal
+    {
+        /**
+         * \brief Time excluded from the measurement of the calling thread with pauseTiming and resumeTiming.
+         */
+        struct PausedTime
+        {
+            /**
+             * \brief Timer ticks at the last call to pauseTiming.
+             */
+            uint64_t start = 0;
+
+            /**
+             * \brief Total ticks between calls to pauseTiming and resumeTiming.
+             */
+            uint64_t ticks = 0;
+
+            /**
+             * \brief Number of calls to resumeTiming.
+             */
+            uint64_t pauses = 0;
+        };
+
+        /**
+         * \brief Paused time of the calling thread. Use pauseTiming, resumeTiming, resetPausedTime and getUnpausedTime
+         * instead of accessing it directly.
+         */
+        inline thread_local PausedTime pausedTime;
+    }  // namespace internal
+
+    /**
+     * \brief Forget the time paused by the calling thread, e.g. before timing the next batch of iterations.
+     */
+    inline void resetPausedTime() noexcept { internal::pausedTime = {}; }
+
+    /**
+     * \brief Stop counting time for the calling thread, e.g. to regenerate the input of a test. Must be followed by a
+     * call to resumeTiming.
+     */
+    inline void pauseTiming() noexcept { internal::pausedTime.start = Timer::get().now(); }
+
+    /**
+     * \brief Resume counting time for the calling thread.
+     */
+    inline void resumeTiming() noexcept
+    {
+        const auto end = Timer::get().now();
+        internal::pausedTime.ticks += end - internal::pausedTime.start;
+        internal::pausedTime.pauses++;
+    }
+
+    /**
+     * \brief Get the time spent in a pair of pauseTiming and resumeTiming calls that is not excluded from measurements.
+     * Measured once on first use.
+     * \return Overhead in ticks.
+     */
+    [[nodiscard]] uint64_t getPauseOverhead();
+
+    /**
+     * \brief Get the time between two timer readings of the calling thread, excluding the time paused since the last
+     * call to resetPausedTime and compensating for the overhead of pausing.
+     * \param start Start ticks.
+     * \param end End ticks.
+     * \return Duration.
+     */
+    [[nodiscard]] std::chrono::nanoseconds getUnpausedTime(uint64_t start, uint64_t end);
+
+    /**
+     * \brief Get the index of the calling thread within a multithreaded benchmark.
+     * \return Index in [0, threads). 0 outside of benchmarks.
+     */
+    [[nodiscard]] size_t getBenchmarkThreadIndex() noexcept;
+
+    /**
+     * \brief Resolve a thread count of a sweep, replacing hardwareThreads with the number of hardware threads.
+     * \param count Thread count.
+     * \return Thread count of at least 1.
+     */
+    [[nodiscard]] int64_t resolveThreadCount(int64_t count) noexcept;
+
+    /**
+     * \brief Compute summary statistics of a list of samples.
+     * \param samples Samples.
+     * \return Statistics. Zero-initialized if there are no samples.
+     */
+    [[nodiscard]] BenchmarkStatistics computeStatistics(std::span<const double> samples);
+
+    /**
+     * \brief Warm up, calibrate the number of iterations per repetition to the target time and measure all repetitions.
+     * With multiple threads, each batch is run by all threads at once. The threads are started once and reused for
+     * all batches. They are released together from a barrier and timed individually.
+     * \param batch Function running a batch of iterations.
+     * \param options Options.
+     * \param threads Number of threads.
+     * \return Results.
+     */
+    [[nodiscard]] BenchmarkResults
+      runBenchmark(const batch_function_t& batch, const BenchmarkOptions& options, size_t threads = 1);
+
+    /**
+     * \brief Record the times of individual iterations in a latency histogram and summarize its tail. Runs
+     * options.latencySamples iterations at most, but no more than a single repetition.
+     * \param sample Function running and timing iterations.
+     * \param options Options.
+     * \param results Results of runBenchmark, which determine the thread count and number of iterations.
+     * \return Distribution.
+     */
+    [[nodiscard]] LatencyDistribution
+      measureLatencyDistribution(const sample_function_t& sample,
+                                 const BenchmarkOptions&  options,
+                                 const BenchmarkResults&  results);
+
+    /**
+     * \brief Get the options with which a cache mode is measured. Cold measurements use at most options.coldIterations
+     * iterations per repetition and no separate warm-up time.
+     * \param options Options.
+     * \param cache Cache mode, either warm or cold.
+     * \return Options.
+     */
+    [[nodiscard]] BenchmarkOptions getCacheModeOptions(const BenchmarkOptions& options, cache_mode_t cache) noexcept;
+
+    /**
+     * \brief Write a human readable comparison of warm and cold results.
+     * \param out Output stream.
+     * \param warm Results with warm caches.
+     * \param cold Results with cold caches.
+     */
+    void printCacheComparison(std::ostream& out, const BenchmarkResults& warm, const BenchmarkResults& cold);
+
+    /**
+     * \brief Convert counters to rates per second, using the time per iteration of each repetition.
+     * \param counters Counters.
+     * \param results Results.
+     * \return Rates of each counter.
+     */
+    [[nodiscard]] std::vector<CounterResults> computeCounterRates(std::span<const Counter> counters,
+                                                                  const BenchmarkResults&  results);
+
+    /**
+     * \brief Find the rates of a counter.
+     * \param results Results.
+     * \param name Counter name.
+     * \return CounterResults, or nullptr.
+     */
+    [[nodiscard]] const CounterResults* findCounter(const BenchmarkResults& results, std::string_view name) noexcept;
+
+    /**
+     * \brief Compute the parallel efficiency of results relative to the results of a reference thread count.
+     * \param results Results.
+     * \param reference Results of the reference thread count, usually a single thread.
+     * \return Throughput per thread relative to that of the reference.
+     */
+    [[nodiscard]] double computeEfficiency(const BenchmarkResults& results, const BenchmarkResults& reference) noexcept;
+
+    /**
+     * \brief Fit the median times of results for different arguments to a complexity class.
+     * \param results Results, one for each argument.
+     * \return Best fit.
+     */
+    [[nodiscard]] ComplexityFit fitBenchmarkComplexity(std::span<const BenchmarkResults> results);
+
+    /**
+     * \brief Write a human readable summary of a complexity fit.
+     * \param out Output stream.
+     * \param fit Fit.
+     * \param expected Expected complexity, if any.
+     */
+    void printComplexityFit(std::ostream& out, const ComplexityFit& fit, std::optional<complexity_t> expected);
+
+    /**
+     * \brief Write a human readable summary of the results.
+     * \param out Output stream.
+     * \param results Results.
+     */
+    void printBenchmarkResults(std::ostream& out, const BenchmarkResults& results);
+}  // namespace bt
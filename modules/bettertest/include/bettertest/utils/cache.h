@@ -0,0 +1,80 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace bt
+{
+    /**
+     * \brief Cache state in which a performance test is measured.
+     */
+    enum class cache_mode_t : uint32_t
+    {
+        /**
+         * \brief Iterations run back to back, so data from the previous iteration is still cached.
+         */
+        warm = 0,
+
+        /**
+         * \brief Caches are evicted before each iteration. The eviction is not part of the measured time.
+         */
+        cold = 1,
+
+        /**
+         * \brief Measure both warm and cold.
+         */
+        both = 2
+    };
+
+    /**
+     * \brief Get the size of the largest CPU cache, usually the last level cache.
+     * \return Size in bytes. A conservative default if unknown.
+     */
+    [[nodiscard]] size_t getLastLevelCacheSize() noexcept;
+
+    /**
+     * \brief Evicts data from the CPU caches, either all of it by streaming over a buffer that is larger than the last
+     * level cache, or a specific range by flushing its cache lines.
+     */
+    class CacheEvictor
+    {
+    public:
+        /**
+         * \brief Allocate and initialize a buffer of twice the last level cache size.
+         */
+        CacheEvictor();
+
+        CacheEvictor(const CacheEvictor&) = delete;
+
+        CacheEvictor(CacheEvictor&&) = delete;
+
+        ~CacheEvictor() noexcept = default;
+
+        CacheEvictor& operator=(const CacheEvictor&) = delete;
+
+        CacheEvictor& operator=(CacheEvictor&&) = delete;
+
+        /**
+         * \brief Evict all caches by reading one value of each cache line of the buffer. Safe to call concurrently.
+         */
+        void evict() const noexcept;
+
+        /**
+         * \brief Flush the cache lines of a range of memory from all caches. Cheaper than evict if the data used by a
+         * test is known. Does nothing on platforms without a cache flush instruction.
+         * \param data Start of range.
+         * \param bytes Size of range in bytes.
+         */
+        static void flush(const void* data, size_t bytes) noexcept;
+
+    private:
+        size_t size = 0;
+
+        std::unique_ptr<std::byte[]> buffer;
+    };
+}  // namespace bt
@@ -0,0 +1,57 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace bt
+{
+    /**
+     * \brief Asymptotic complexity classes, in order of growth.
+     */
+    enum class complexity_t : uint32_t
+    {
+        constant     = 0,
+        logarithmic  = 1,
+        linear       = 2,
+        linearithmic = 3,
+        quadratic    = 4
+    };
+
+    /**
+     * \brief Best fit of measured times to a complexity class.
+     */
+    struct ComplexityFit
+    {
+        complexity_t complexity = complexity_t::constant;
+
+        /**
+         * \brief Coefficient of the fitted function, i.e. time = coefficient * f(n).
+         */
+        double coefficient = 0;
+
+        /**
+         * \brief Root mean square of the residuals, relative to the mean time.
+         */
+        double rms = 0;
+    };
+
+    /**
+     * \brief Get the big O notation of a complexity class.
+     * \param complexity Complexity class.
+     * \return String.
+     */
+    [[nodiscard]] std::string_view toString(complexity_t complexity) noexcept;
+
+    /**
+     * \brief Fit times to each complexity class with least squares and select the class with the lowest RMS.
+     * \param arguments Problem sizes.
+     * \param times Time for each problem size.
+     * \return Best fit.
+     */
+    [[nodiscard]] ComplexityFit fitComplexity(std::span<const int64_t> arguments, std::span<const double> times);
+}  // namespace bt
@@ -4,9 +4,31 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <chrono>
+#include <optional>
 #include <string>
 
 namespace bt
 {
-    std::string dateTimeAsString();
-}
+    using date_time_t = std::chrono::system_clock::time_point;
+
+    /**
+     * \brief Format the current date and time, e.g. "2023-04-01 12:34:56.123456789 UTC".
+     * \return Date and time string.
+     */
+    [[nodiscard]] std::string dateTimeAsString();
+
+    /**
+     * \brief Format a date and time, e.g. "2023-04-01 12:34:56.123456789 UTC". Intended for exporters that write text.
+     * \param time Date and time.
+     * \return Date and time string.
+     */
+    [[nodiscard]] std::string dateTimeAsString(date_time_t time);
+
+    /**
+     * \brief Parse a date and time formatted by dateTimeAsString. Intended for importers that read text.
+     * \param str Date and time string.
+     * \return Date and time, or empty if the string could not be parsed.
+     */
+    [[nodiscard]] std::optional<date_time_t> parseDateTime(const std::string& str);
+}  // namespace bt
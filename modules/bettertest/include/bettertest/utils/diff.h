@@ -0,0 +1,77 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace bt
+{
+    /**
+     * \brief Options that bound the amount of work and output of diffText and diffBytes.
+     */
+    struct DiffOptions
+    {
+        /**
+         * \brief Number of unchanged lines (or byte rows) shown around each change.
+         */
+        size_t context = 3;
+
+        /**
+         * \brief Maximum number of lines in the diff excerpt. Remaining changes are omitted.
+         */
+        size_t maxOutputLines = 64;
+
+        /**
+         * \brief Maximum number of characters printed per line of text. Longer lines are truncated.
+         */
+        size_t maxLineLength = 160;
+
+        /**
+         * \brief Maximum number of lines (or bytes) of each side of the changed region that are aligned. Keeps time and
+         * memory bounded for very large inputs. Changes beyond this window are not shown.
+         */
+        size_t window = 4096;
+    };
+
+    /**
+     * \brief Find the first position at which two byte spans differ. Uses SIMD instructions where available.
+     * \param lhs Left-hand side.
+     * \param rhs Right-hand side.
+     * \return Index of first mismatch. If one span is a prefix of the other, the size of the shortest span.
+     */
+    [[nodiscard]] size_t findFirstMismatch(std::span<const std::byte> lhs, std::span<const std::byte> rhs) noexcept;
+
+    /**
+     * \brief Find the length of the common suffix of two byte spans. Uses SIMD instructions where available.
+     * \param lhs Left-hand side.
+     * \param rhs Right-hand side.
+     * \return Number of equal bytes at the end of both spans.
+     */
+    [[nodiscard]] size_t findCommonSuffix(std::span<const std::byte> lhs, std::span<const std::byte> rhs) noexcept;
+
+    /**
+     * \brief Create a line based unified diff excerpt of two strings. Only the region between the common prefix and
+     * suffix is aligned, using the linear space variant of Myers' algorithm.
+     * \param lhs Left-hand side.
+     * \param rhs Right-hand side.
+     * \param options Options.
+     * \return Diff excerpt. Empty if both strings are equal.
+     */
+    [[nodiscard]] std::string diffText(std::string_view lhs, std::string_view rhs, const DiffOptions& options);
+
+    /**
+     * \brief Create a unified diff excerpt of two byte spans, printed as rows of hexadecimal bytes. Only the region
+     * between the common prefix and suffix is aligned, using the linear space variant of Myers' algorithm.
+     * \param lhs Left-hand side.
+     * \param rhs Right-hand side.
+     * \param options Options.
+     * \return Diff excerpt. Empty if both spans are equal.
+     */
+    [[nodiscard]] std::string
+      diffBytes(std::span<const std::byte> lhs, std::span<const std::byte> rhs, const DiffOptions& options);
+}  // namespace bt
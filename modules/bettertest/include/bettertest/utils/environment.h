@@ -0,0 +1,159 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bt
+{
+    /**
+     * \brief Description of the machine state while performance tests are run.
+     */
+    struct BenchmarkEnvironment
+    {
+        /**
+         * \brief CPU to which performance tests are pinned. -1 if not pinned.
+         */
+        int32_t cpu = -1;
+
+        /**
+         * \brief Whether the CPU is isolated from the scheduler (isolcpus).
+         */
+        bool isolated = false;
+
+        /**
+         * \brief Frequency scaling governor of the CPU. Empty if unknown.
+         */
+        std::string governor;
+
+        /**
+         * \brief Whether turbo boost is enabled. Empty if unknown.
+         */
+        std::optional<bool> turbo;
+
+        /**
+         * \brief Load average over the last minute. Empty if unknown.
+         */
+        std::optional<double> loadAverage;
+
+        /**
+         * \brief Reasons why the environment is unfit for benchmarking: the CPU could not be pinned although the
+         * platform supports it, or a large part of the CPUs is busy.
+         */
+        std::vector<std::string> errors;
+
+        /**
+         * \brief Settings that add noise to measurements, such as frequency scaling and turbo boost. Common on
+         * desktops and cloud machines, so they do not make the environment unfit.
+         */
+        std::vector<std::string> warnings;
+
+        /**
+         * \brief Returns whether no errors were found.
+         * \return True or false.
+         */
+        [[nodiscard]] bool isFit() const noexcept { return errors.empty(); }
+
+        /**
+         * \brief Returns whether neither errors nor warnings were found.
+         * \return True or false.
+         */
+        [[nodiscard]] bool isStrictlyFit() const noexcept { return errors.empty() && warnings.empty(); }
+    };
+
+    /**
+     * \brief Pins the calling thread to a single CPU for its lifetime and restores the previous affinity afterwards.
+     * Prefers the first isolated CPU, otherwise uses the CPU the thread is currently running on. Only one CpuPinning
+     * may be active at a time. Only supported on Linux.
+     */
+    class CpuPinning
+    {
+    public:
+        CpuPinning();
+
+        CpuPinning(const CpuPinning&) = delete;
+
+        CpuPinning(CpuPinning&&) = delete;
+
+        ~CpuPinning() noexcept;
+
+        CpuPinning& operator=(const CpuPinning&) = delete;
+
+        CpuPinning& operator=(CpuPinning&&) = delete;
+
+        /**
+         * \brief Get the CPU to which the thread was pinned.
+         * \return CPU index, or -1 if pinning failed.
+         */
+        [[nodiscard]] int32_t getCpu() const noexcept;
+
+        /**
+         * \brief Returns whether the CPU is isolated from the scheduler.
+         * \return True or false.
+         */
+        [[nodiscard]] bool isIsolated() const noexcept;
+
+    private:
+        int32_t cpu      = -1;
+        bool    isolated = false;
+    };
+
+    /**
+     * \brief Lifts the active CpuPinning from the calling thread for its lifetime and pins the thread to the same CPU
+     * again afterwards. Used by code under test that starts threads of its own, which would otherwise inherit the
+     * pinning and share a single CPU. Does nothing if the calling thread is not pinned.
+     */
+    class CpuUnpinning
+    {
+    public:
+        CpuUnpinning() noexcept;
+
+        CpuUnpinning(const CpuUnpinning&) = delete;
+
+        CpuUnpinning(CpuUnpinning&&) = delete;
+
+        ~CpuUnpinning() noexcept;
+
+        CpuUnpinning& operator=(const CpuUnpinning&) = delete;
+
+        CpuUnpinning& operator=(CpuUnpinning&&) = delete;
+
+    private:
+        /**
+         * \brief CPU to pin to again, or -1 if the thread was not pinned.
+         */
+        int32_t cpu = -1;
+    };
+
+    /**
+     * \brief Returns whether CpuPinning can pin threads on this platform.
+     * \return True or false.
+     */
+    [[nodiscard]] bool isCpuPinningSupported() noexcept;
+
+    /**
+     * \brief Restore the affinity that the calling thread would have had without an active CpuPinning. Used by
+     * threads that are started by pinned threads, such as the workers of multithreaded benchmarks. Does nothing if no
+     * CpuPinning is active.
+     */
+    void unpinThread() noexcept;
+
+    /**
+     * \brief Inspect CPU pinning, frequency scaling, turbo boost and system load and collect errors and warnings for
+     * anything that makes measurements unreliable.
+     * \param pinning Active CPU pinning.
+     * \return Environment.
+     */
+    [[nodiscard]] BenchmarkEnvironment inspectEnvironment(const CpuPinning& pinning);
+
+    /**
+     * \brief Read the number of thermal throttling events of the CPU the calling thread runs on.
+     * \return Count, or 0 if unknown.
+     */
+    [[nodiscard]] uint64_t readThrottleCount();
+}  // namespace bt
@@ -0,0 +1,154 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bt
+{
+    /**
+     * \brief High dynamic range histogram of non-negative integer values. Values are recorded with a fixed number of
+     * significant decimal digits over the whole range, e.g. with 3 digits 1234 and 1234567 are stored as 1234 and
+     * 1234xxx. Memory usage depends only on the range and precision, not on the number of recorded values.
+     */
+    class Histogram
+    {
+    public:
+        /**
+         * \brief Create a histogram.
+         * \param highest Highest value that can be recorded. Larger values are recorded as this value.
+         * \param significantDigits Number of significant decimal digits, clamped to [1, 5].
+         */
+        explicit Histogram(uint64_t highest, uint32_t significantDigits = 3);
+
+        Histogram(const Histogram&) = default;
+
+        Histogram(Histogram&&) noexcept = default;
+
+        ~Histogram() noexcept = default;
+
+        Histogram& operator=(const Histogram&) = default;
+
+        Histogram& operator=(Histogram&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] uint64_t getHighest() const noexcept { return highest; }
+
+        [[nodiscard]] uint32_t getSignificantDigits() const noexcept { return significantDigits; }
+
+        /**
+         * \brief Get the number of recorded values.
+         * \return Count.
+         */
+        [[nodiscard]] uint64_t getTotalCount() const noexcept { return totalCount; }
+
+        /**
+         * \brief Get the exact smallest recorded value.
+         * \return Value, or 0 if empty.
+         */
+        [[nodiscard]] uint64_t getMin() const noexcept { return totalCount ? min : 0; }
+
+        /**
+         * \brief Get the exact largest recorded value.
+         * \return Value, or 0 if empty.
+         */
+        [[nodiscard]] uint64_t getMax() const noexcept { return max; }
+
+        /**
+         * \brief Get the value below or at which the given percentage of recorded values lies. The value is the
+         * highest value that is equivalent within the precision of the histogram, clamped to the exact maximum.
+         * \param percentile Percentile in [0, 100].
+         * \return Value, or 0 if empty.
+         */
+        [[nodiscard]] uint64_t getValueAtPercentile(double percentile) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Recording.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Record a value.
+         * \param value Value.
+         */
+        void record(uint64_t value) noexcept
+        {
+            value = std::min(value, highest);
+            counts[getIndex(value)]++;
+            totalCount++;
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+
+        /**
+         * \brief Add all values recorded by another histogram. The other histogram must have the same range and
+         * precision.
+         * \param other Histogram.
+         * \return False if the histograms are incompatible.
+         */
+        bool merge(const Histogram& other) noexcept;
+
+        /**
+         * \brief Remove all recorded values.
+         */
+        void reset() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Encoding.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Encode the histogram as a compact printable string. Counts are stored as variable length integers,
+         * with runs of empty buckets collapsed, and the result is base64 encoded.
+         * \return Encoded histogram.
+         */
+        [[nodiscard]] std::string encode() const;
+
+        /**
+         * \brief Decode a histogram created by encode.
+         * \param encoded Encoded histogram.
+         * \return Histogram, or empty if the string is malformed.
+         */
+        [[nodiscard]] static std::optional<Histogram> decode(std::string_view encoded);
+
+    private:
+        [[nodiscard]] size_t getIndex(const uint64_t value) const noexcept
+        {
+            // Values below subBucketCount are stored exactly in the first bucket. Each following bucket covers twice
+            // the range of the previous one with the same number of sub-buckets.
+            const auto bucket    = static_cast<uint32_t>(std::bit_width(value | subBucketMask)) - subBucketMagnitude;
+            const auto subBucket = value >> bucket;
+            return (static_cast<size_t>(bucket + 1) << (subBucketMagnitude - 1)) + subBucket - (subBucketCount >> 1);
+        }
+
+        [[nodiscard]] uint64_t getValueFromIndex(size_t index) const noexcept;
+
+        [[nodiscard]] uint64_t getHighestEquivalentValue(uint64_t value) const noexcept;
+
+        uint64_t highest           = 0;
+        uint32_t significantDigits = 0;
+
+        /**
+         * \brief Number of sub-buckets in each bucket, the smallest power of 2 that resolves the requested digits.
+         */
+        uint64_t subBucketCount     = 0;
+        uint64_t subBucketMask      = 0;
+        uint32_t subBucketMagnitude = 0;
+
+        uint64_t totalCount = 0;
+        uint64_t min        = UINT64_MAX;
+        uint64_t max        = 0;
+
+        std::vector<uint64_t> counts;
+    };
+}  // namespace bt
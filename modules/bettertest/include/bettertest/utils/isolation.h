@@ -0,0 +1,121 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/suite/test_data.h"
+
+namespace bt
+{
+    /**
+     * \brief Resources a test may use when it runs in an isolated process. A value of 0 means unlimited. Tests can
+     * declare their own limits with a static constexpr member named limits, which take precedence over the limits of
+     * the suite:
+     *
+     * \code
+     * static constexpr bt::ResourceLimits limits{.memory = 256 * 1024 * 1024, .cpuSeconds = 10};
+     * \endcode
+     */
+    struct ResourceLimits
+    {
+        /**
+         * \brief Number of bytes of address space the test may map in addition to what the process already uses.
+         */
+        uint64_t memory = 0;
+
+        /**
+         * \brief Number of seconds of CPU time the test may use.
+         */
+        uint64_t cpuSeconds = 0;
+
+        /**
+         * \brief Number of files the test may open in addition to the files the process already has open.
+         */
+        uint64_t openFiles = 0;
+
+        /**
+         * \brief Number of seconds of wall-clock time after which the test is killed. If 0, isolatedTimeout is used.
+         */
+        uint64_t wallSeconds = 0;
+
+        /**
+         * \brief Returns whether any limit is set.
+         * \return True or false.
+         */
+        [[nodiscard]] constexpr bool any() const noexcept { return memory || cpuSeconds || openFiles || wallSeconds; }
+
+        /**
+         * \brief Fill in the limits that are not set with those of another object.
+         * \param defaults Default limits.
+         * \return Combined limits.
+         */
+        [[nodiscard]] constexpr ResourceLimits withDefaults(const ResourceLimits& defaults) const noexcept
+        {
+            return {.memory      = memory ? memory : defaults.memory,
+                    .cpuSeconds  = cpuSeconds ? cpuSeconds : defaults.cpuSeconds,
+                    .openFiles   = openFiles ? openFiles : defaults.openFiles,
+                    .wallSeconds = wallSeconds ? wallSeconds : defaults.wallSeconds};
+        }
+    };
+
+    /**
+     * \brief Wall-clock time after which an isolated test is killed if ResourceLimits::wallSeconds is not set. A test
+     * process can never hang the suite, including a child that deadlocks on a lock that another thread held while it
+     * was forked.
+     */
+    inline constexpr uint64_t isolatedTimeout = 600;
+
+    /**
+     * \brief Result of a test that ran in an isolated process.
+     */
+    struct IsolatedResult
+    {
+        bool pass = false;
+
+        /**
+         * \brief Error message of the test, or a description of the limit that was exceeded or of the crash.
+         */
+        std::string error;
+
+        /**
+         * \brief Output written by the test.
+         */
+        std::string output;
+
+        failure_t failure = failure_t::failed;
+    };
+
+    /**
+     * \brief Function that runs a test, writing its output to a stream. Returns the passing state of the test and an
+     * optional error message.
+     */
+    using isolated_function_t = std::function<std::pair<bool, std::string>(std::ostream&)>;
+
+    /**
+     * \brief Returns whether tests can be run in isolated processes on this platform.
+     * \return True or false.
+     */
+    [[nodiscard]] bool isIsolationSupported() noexcept;
+
+    /**
+     * \brief Run a function in a child process with the given resource limits and wait for it to finish. A crash or
+     * exceeded limit of the function does not affect the calling process. Safe to call concurrently. The child is
+     * forked, so it only inherits the calling thread. If another thread held a lock the function needs while the child
+     * was created, the child deadlocks and is killed once its wall-clock time limit has passed.
+     * \param f Function. Its side effects, other than on files, are not visible to the calling process.
+     * \param limits Resource limits of the child process.
+     * \return Result.
+     */
+    [[nodiscard]] IsolatedResult runIsolated(const isolated_function_t& f, const ResourceLimits& limits);
+}  // namespace bt
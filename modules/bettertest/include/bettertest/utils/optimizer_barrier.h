@@ -0,0 +1,78 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <type_traits>
+
+#if defined _MSC_VER && !defined __clang__
+#include <intrin.h>
+#endif
+
+namespace bt
+{
+    namespace internal
+    {
+        /**
+         * \brief Opaque function used as an optimizer barrier on compilers without GNU inline assembly.
+         */
+        void useCharPointer(const volatile char* ptr) noexcept;
+    }  // namespace internal
+
+#if defined __GNUC__ || defined __clang__
+    /**
+     * \brief Prevent the compiler from optimizing away the computation of a value. The value is treated as if it is
+     * read by code the compiler cannot see. Does not prevent the compiler from caching the value in a register.
+     * \tparam T Value type.
+     * \param value Value.
+     */
+    template<typename T>
+    [[gnu::always_inline]] inline void doNotOptimize(const T& value) noexcept
+    {
+        // Allow a register for small values to avoid forcing a store to memory.
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * \brief Prevent the compiler from optimizing away the computation of a value. The value is treated as if it is
+     * read and modified by code the compiler cannot see, so computations depending on it cannot be hoisted out of
+     * a loop either.
+     * \tparam T Value type.
+     * \param value Value.
+     */
+    template<typename T>
+    [[gnu::always_inline]] inline void doNotOptimize(T& value) noexcept
+    {
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(T*))
+        {
+            // Register sized values can stay in a register. Clang prefers the first alternative, GCC the last.
+#if defined __clang__
+            asm volatile("" : "+r,m"(value) : : "memory");
+#else
+            asm volatile("" : "+m,r"(value) : : "memory");
+#endif
+        }
+        else
+        {
+            // Larger values must be in memory.
+            asm volatile("" : "+m"(value) : : "memory");
+        }
+    }
+
+    /**
+     * \brief Force all pending writes to global memory to be performed and prevent the compiler from assuming that
+     * memory is unchanged after this point.
+     */
+    [[gnu::always_inline]] inline void clobberMemory() noexcept { asm volatile("" : : : "memory"); }
+#else
+    template<typename T>
+    inline void doNotOptimize(const T& value) noexcept
+    {
+        internal::useCharPointer(&reinterpret_cast<const volatile char&>(value));
+        _ReadWriteBarrier();
+    }
+
+    inline void clobberMemory() noexcept { _ReadWriteBarrier(); }
+#endif
+}  // namespace bt
@@ -0,0 +1,102 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace bt
+{
+    /**
+     * \brief Hardware events that can be counted by PerfCounters.
+     */
+    enum class perf_event_t : uint32_t
+    {
+        instructions  = 0,
+        cycles        = 1,
+        cache_misses  = 2,
+        branch_misses = 3
+    };
+
+    /**
+     * \brief Counts measured by PerfCounters. Hardware counts are empty if the event could not be opened.
+     */
+    struct PerfCounts
+    {
+        std::optional<uint64_t> instructions;
+        std::optional<uint64_t> cycles;
+        std::optional<uint64_t> cacheMisses;
+        std::optional<uint64_t> branchMisses;
+
+        /**
+         * \brief CPU time spent by the measuring thread in nanoseconds. Always available.
+         */
+        uint64_t taskClock = 0;
+
+        [[nodiscard]] std::optional<uint64_t> get(perf_event_t event) const noexcept;
+    };
+
+    /**
+     * \brief Group of hardware performance counters of the calling thread, opened with perf_event_open. Counters only
+     * include user space events. If counters are not permitted (e.g. by perf_event_paranoid or on other platforms
+     * than Linux), only the software task clock is measured. Must be started and stopped on the thread that created it.
+     */
+    class PerfCounters
+    {
+    public:
+        PerfCounters() noexcept;
+
+        PerfCounters(const PerfCounters&) = delete;
+
+        PerfCounters(PerfCounters&&) = delete;
+
+        ~PerfCounters() noexcept;
+
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        PerfCounters& operator=(PerfCounters&&) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Returns whether at least one hardware counter could be opened.
+         * \return True or false.
+         */
+        [[nodiscard]] bool hasHardwareCounters() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Measuring.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Reset and start all counters.
+         */
+        void start() noexcept;
+
+        /**
+         * \brief Stop all counters and read them. Counts are scaled if the kernel had to multiplex the counters.
+         * \return Counts since start.
+         */
+        [[nodiscard]] PerfCounts stop() noexcept;
+
+    private:
+        static constexpr size_t eventCount = 4;
+
+        /**
+         * \brief File descriptors of the hardware events. The first open descriptor is the group leader.
+         */
+        std::array<int, eventCount> fds;
+
+        /**
+         * \brief File descriptor of the software task clock.
+         */
+        int clockFd = -1;
+
+        uint64_t clockStart = 0;
+    };
+}  // namespace bt
@@ -0,0 +1,107 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+
+namespace bt
+{
+    /**
+     * \brief Statistical profiler that periodically samples the call stack of a single thread. Sampling is driven by
+     * the SIGPROF signal of a timer on the CPU time of that thread (timer_create), which is delivered to that thread
+     * only, and stacks are captured by following frame pointers into a preallocated buffer, so the signal handler
+     * neither locks nor allocates. Code should be compiled with -fno-omit-frame-pointer to get complete stacks, and
+     * linked with -rdynamic to resolve the names of functions in the executable. Only supported on Linux on x86-64 and
+     * aarch64. Only one profiler can be active at a time.
+     */
+    class SamplingProfiler
+    {
+    public:
+        /**
+         * \brief Create a profiler. The sample buffer is allocated here.
+         * \param frequency Number of samples per second of CPU time.
+         * \param capacity Maximum number of samples. Further samples are dropped.
+         * \param maxDepth Maximum number of frames per sample.
+         */
+        explicit SamplingProfiler(uint32_t frequency = 1000, size_t capacity = 16384, size_t maxDepth = 64);
+
+        SamplingProfiler(const SamplingProfiler&) = delete;
+
+        SamplingProfiler(SamplingProfiler&&) = delete;
+
+        ~SamplingProfiler() noexcept;
+
+        SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+        SamplingProfiler& operator=(SamplingProfiler&&) = delete;
+
+        /**
+         * \brief Returns whether sampling is supported on this platform.
+         * \return True or false.
+         */
+        [[nodiscard]] static bool isAvailable() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of samples in the buffer.
+         * \return Count.
+         */
+        [[nodiscard]] size_t getSampleCount() const noexcept;
+
+        /**
+         * \brief Get the number of samples that were dropped because the buffer was full.
+         * \return Count.
+         */
+        [[nodiscard]] size_t getDroppedCount() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Sampling.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Start sampling the calling thread. Samples of consecutive start and stop calls accumulate.
+         * \return False if sampling is not available or another profiler is active.
+         */
+        bool start();
+
+        /**
+         * \brief Stop sampling. Does nothing if not started.
+         */
+        void stop() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Output.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Write all samples in the folded stack format, i.e. one line per unique stack of semicolon separated
+         * function names from outermost to innermost, followed by the number of samples. This is the input format of
+         * flame graph tools.
+         * \param out Output stream.
+         */
+        void writeFoldedStacks(std::ostream& out) const;
+
+        /**
+         * \brief Write all samples in the folded stack format to a file.
+         * \param file File path.
+         * \return False if the file could not be written.
+         */
+        bool writeFoldedStacks(const std::filesystem::path& file) const;
+
+        /**
+         * \brief Buffers and settings, shared with the signal handler.
+         */
+        struct State;
+
+    private:
+        std::unique_ptr<State> state;
+    };
+}  // namespace bt
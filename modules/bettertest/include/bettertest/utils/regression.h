@@ -0,0 +1,81 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <span>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/benchmark.h"
+
+namespace bt
+{
+    /**
+     * \brief Result of a Mann-Whitney U test.
+     */
+    struct MannWhitneyResult
+    {
+        /**
+         * \brief U statistic of the first sample.
+         */
+        double u = 0;
+
+        /**
+         * \brief Standardized U statistic, corrected for ties.
+         */
+        double z = 0;
+
+        /**
+         * \brief One-sided p-value of the hypothesis that values of the first sample tend to be larger.
+         */
+        double p = 1;
+    };
+
+    /**
+     * \brief Outcome of comparing the samples of a performance test against its baseline.
+     */
+    struct RegressionResult
+    {
+        /**
+         * \brief True if the samples are both significantly and substantially slower than the baseline.
+         */
+        bool regression = false;
+
+        /**
+         * \brief Relative change of the median compared to the baseline median. Positive means slower, i.e. a larger
+         * time or a lower rate.
+         */
+        double shift = 0;
+
+        /**
+         * \brief One-sided p-value of the samples being slower than the baseline.
+         */
+        double p = 1;
+    };
+
+    /**
+     * \brief Perform a Mann-Whitney U test using the normal approximation.
+     * \param a First sample.
+     * \param b Second sample.
+     * \return Result. If either sample is empty, p is 1.
+     */
+    [[nodiscard]] MannWhitneyResult mannWhitneyU(std::span<const double> a, std::span<const double> b);
+
+    /**
+     * \brief Compare samples against a baseline. A regression requires that the samples are significantly slower
+     * according to options.significance, and that the median is slower by at least options.regressionThreshold.
+     * \param samples Samples of the current run.
+     * \param baseline Samples of previous runs.
+     * \param options Options.
+     * \param higherIsBetter If true, samples are rates and lower values are slower. Otherwise, samples are times.
+     * \return Result.
+     */
+    [[nodiscard]] RegressionResult detectRegression(std::span<const double> samples,
+                                                    std::span<const double> baseline,
+                                                    const BenchmarkOptions& options,
+                                                    bool                    higherIsBetter = false);
+}  // namespace bt
@@ -23,4 +23,13 @@ namespace bt
         std::source_location location;
         std::string          error;
     };
+
+    /**
+     * \brief Named measurement recorded by a mixin, e.g. the number of allocations performed by a test.
+     */
+    struct Metric
+    {
+        std::string name;
+        double      value;
+    };
 }  // namespace bt
@@ -0,0 +1,165 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bt
+{
+    /**
+     * \brief The ThreadBuffers class gives each thread its own buffer of type T, so that threads can record without
+     * contending for a lock. Buffers are registered on first use and kept in order of registration until cleared. Each
+     * thread caches the buffers it used last in a small thread_local table keyed by the identifier of their
+     * ThreadBuffers, so only the first access of each thread takes the lock, even when a thread alternates between
+     * several objects, such as the mixins of one test.
+     * \tparam T Buffer type.
+     */
+    template<typename T>
+    class ThreadBuffers
+    {
+    public:
+        ThreadBuffers() : id(nextId()) {}
+
+        ThreadBuffers(const ThreadBuffers&) = delete;
+
+        ThreadBuffers(ThreadBuffers&&) = delete;
+
+        ~ThreadBuffers() noexcept = default;
+
+        ThreadBuffers& operator=(const ThreadBuffers&) = delete;
+
+        ThreadBuffers& operator=(ThreadBuffers&&) = delete;
+
+        /**
+         * \brief Get the buffer of the calling thread, registering a new one if needed.
+         * \tparam F Callable type.
+         * \param init Called with a new buffer and its index of registration before the buffer is used.
+         * \return Buffer.
+         */
+        template<typename F>
+        [[nodiscard]] T& get(F&& init)
+        {
+            for (const auto& c : cache.entries)
+                if (c.owner == id) return *c.buffer;
+
+            // Look for an existing buffer of this thread or register a new one.
+            std::scoped_lock lock(mutex);
+            const auto       thread = std::this_thread::get_id();
+            auto             it     = std::ranges::find_if(entries, [&](const Entry& e) { return e.thread == thread; });
+            if (it == entries.end())
+            {
+                auto buffer = std::make_unique<T>();
+                init(*buffer, entries.size());
+                entries.emplace_back(thread, std::move(buffer));
+                it = std::prev(entries.end());
+            }
+
+            // Replace the oldest cache entry.
+            cache.entries[cache.next] = {id, it->buffer.get()};
+            cache.next                = (cache.next + 1) % cacheSize;
+            return *it->buffer;
+        }
+
+        /**
+         * \brief Get the buffer of the calling thread, registering a new one if needed.
+         * \return Buffer.
+         */
+        [[nodiscard]] T& get() { return get([](T&, size_t) {}); }
+
+        /**
+         * \brief Call a function for each buffer in order of registration. Holds the lock while iterating.
+         * \tparam F Callable type.
+         * \param f Callable taking a buffer.
+         */
+        template<typename F>
+        void forEach(F&& f)
+        {
+            std::scoped_lock lock(mutex);
+            for (auto& e : entries) f(*e.buffer);
+        }
+
+        /**
+         * \brief Call a function for each buffer in order of registration. Holds the lock while iterating.
+         * \tparam F Callable type.
+         * \param f Callable taking a buffer.
+         */
+        template<typename F>
+        void forEach(F&& f) const
+        {
+            std::scoped_lock lock(mutex);
+            for (const auto& e : entries) f(std::as_const(*e.buffer));
+        }
+
+        /**
+         * \brief Release all buffers. Must not be called while other threads are recording.
+         */
+        void clear()
+        {
+            std::scoped_lock lock(mutex);
+            entries.clear();
+
+            // Invalidate any thread caches still pointing to the released buffers.
+            id = nextId();
+        }
+
+    private:
+        struct Entry
+        {
+            std::thread::id thread;
+
+            std::unique_ptr<T> buffer;
+        };
+
+        /**
+         * \brief Number of ThreadBuffers objects whose buffers a thread caches.
+         */
+        static constexpr size_t cacheSize = 8;
+
+        /**
+         * \brief Buffer used by the calling thread, and the identifier of the ThreadBuffers it belongs to.
+         */
+        struct CacheEntry
+        {
+            uint64_t owner  = 0;
+            T*       buffer = nullptr;
+        };
+
+        /**
+         * \brief Buffers last used by the calling thread.
+         */
+        struct Cache
+        {
+            std::array<CacheEntry, cacheSize> entries;
+
+            size_t next = 0;
+        };
+
+        [[nodiscard]] static uint64_t nextId() noexcept
+        {
+            // Start at 1 so that 0 is never a valid id in the cache.
+            static std::atomic<uint64_t> next = 1;
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static inline thread_local Cache cache;
+
+        /**
+         * \brief Unique identifier of this object, used to look up the buffer of the calling thread in the cache.
+         */
+        uint64_t id;
+
+        mutable std::mutex mutex;
+
+        std::vector<Entry> entries;
+    };
+}  // namespace bt
@@ -0,0 +1,133 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#if defined __x86_64__ || defined _M_X64
+#if defined _MSC_VER && !defined __clang__
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace bt
+{
+    /**
+     * \brief Timer used to measure performance tests. Uses the invariant time stamp counter (rdtscp) on x86-64 or the
+     * virtual counter (cntvct) on aarch64 when available, and std::chrono::steady_clock otherwise. The counter is
+     * calibrated against steady_clock once, and the overhead of reading it is subtracted from all measurements.
+     */
+    class Timer
+    {
+    public:
+        enum class type_t : uint32_t
+        {
+            steady_clock  = 0,
+            cycle_counter = 1
+        };
+
+        Timer(const Timer&) = delete;
+
+        Timer(Timer&&) = delete;
+
+        ~Timer() = default;
+
+        Timer& operator=(const Timer&) = delete;
+
+        Timer& operator=(Timer&&) = delete;
+
+        /**
+         * \brief Get the calibrated timer. The first call selects a backend and calibrates it, which takes a few
+         * milliseconds.
+         * \return Timer.
+         */
+        [[nodiscard]] static const Timer& get();
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] type_t getType() const noexcept { return type; }
+
+        /**
+         * \brief Get a short name of the selected backend.
+         * \return Name.
+         */
+        [[nodiscard]] std::string_view getName() const noexcept;
+
+        /**
+         * \brief Get the number of ticks per nanosecond.
+         * \return Frequency.
+         */
+        [[nodiscard]] double getTicksPerNanosecond() const noexcept { return ticksPerNs; }
+
+        /**
+         * \brief Get the overhead of a pair of now() calls.
+         * \return Overhead in ticks.
+         */
+        [[nodiscard]] uint64_t getOverhead() const noexcept { return overhead; }
+
+        ////////////////////////////////////////////////////////////////
+        // Measuring.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Read the current time.
+         * \return Time in ticks.
+         */
+        [[nodiscard]] uint64_t now() const noexcept
+        {
+            if (type == type_t::cycle_counter) return readCycleCounter();
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+
+        /**
+         * \brief Convert the ticks between two calls to now() to a duration, subtracting the timer overhead.
+         * \param start Start ticks.
+         * \param end End ticks.
+         * \return Duration.
+         */
+        [[nodiscard]] std::chrono::nanoseconds elapsed(const uint64_t start, const uint64_t end) const noexcept
+        {
+            const auto ticks = end - start > overhead ? end - start - overhead : 0;
+            return std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(ticks) / ticksPerNs));
+        }
+
+        /**
+         * \brief Read the hardware cycle counter.
+         * \return Counter value, or 0 if there is none.
+         */
+        [[nodiscard]] static uint64_t readCycleCounter() noexcept
+        {
+#if defined __x86_64__ || defined _M_X64
+            // rdtscp waits for all previous instructions to complete. The fence keeps later instructions from starting
+            // before the counter is read, so that short intervals, such as those between pauses, are not shortened.
+            unsigned int aux   = 0;
+            const auto   ticks = __rdtscp(&aux);
+            _mm_lfence();
+            return ticks;
+#elif defined __aarch64__
+            uint64_t value = 0;
+            asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(value) : : "memory");
+            return value;
+#else
+            return 0;
+#endif
+        }
+
+    private:
+        Timer();
+
+        type_t type = type_t::steady_clock;
+
+        double ticksPerNs = 1;
+
+        uint64_t overhead = 0;
+    };
+}  // namespace bt
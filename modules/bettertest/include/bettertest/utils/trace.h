@@ -0,0 +1,183 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/thread_buffers.h"
+
+namespace bt
+{
+    /**
+     * \brief The Tracer class records spans of time on any number of threads and writes them as Chrome trace events,
+     * which can be opened in Perfetto or chrome://tracing. Each thread records into its own buffer, so recording does
+     * not take a lock after the first span of a thread.
+     */
+    class Tracer
+    {
+    public:
+        /**
+         * \brief A completed span.
+         */
+        struct Span
+        {
+            std::string name;
+
+            std::string_view category;
+
+            /**
+             * \brief Start in nanoseconds since the Tracer was created.
+             */
+            uint64_t start = 0;
+
+            /**
+             * \brief Duration in nanoseconds.
+             */
+            uint64_t duration = 0;
+        };
+
+        Tracer();
+
+        Tracer(const Tracer&) = delete;
+
+        Tracer(Tracer&&) = delete;
+
+        ~Tracer() noexcept = default;
+
+        Tracer& operator=(const Tracer&) = delete;
+
+        Tracer& operator=(Tracer&&) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Recording.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the current time.
+         * \return Nanoseconds since the Tracer was created.
+         */
+        [[nodiscard]] uint64_t now() const noexcept;
+
+        /**
+         * \brief Record a span for the calling thread. Safe to call concurrently.
+         * \param name Span name.
+         * \param category Span category. Must outlive the Tracer, e.g. a string literal.
+         * \param start Start time as returned by now().
+         * \param end End time as returned by now().
+         */
+        void record(std::string_view name, std::string_view category, uint64_t start, uint64_t end);
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of spans recorded by all threads. Must not be called while other threads are recording.
+         * \return Number of spans.
+         */
+        [[nodiscard]] size_t getSpanCount() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Writing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Write all spans in the Chrome trace event format. Must not be called while other threads are
+         * recording.
+         * \param out Output.
+         */
+        void write(std::ostream& out) const;
+
+        /**
+         * \brief Write all spans in the Chrome trace event format to a file. Creates the parent directory if
+         * necessary.
+         * \param file File path.
+         * \return True if the file was written.
+         */
+        [[nodiscard]] bool write(const std::filesystem::path& file) const;
+
+    private:
+        /**
+         * \brief Spans of a single thread.
+         */
+        struct ThreadBuffer
+        {
+            /**
+             * \brief Thread identifier written to the trace. The OS thread ID where available.
+             */
+            uint64_t tid = 0;
+
+            bool main = false;
+
+            std::vector<Span> spans;
+        };
+
+        [[nodiscard]] ThreadBuffer& getThreadBuffer();
+
+        std::chrono::steady_clock::time_point origin;
+
+        std::thread::id mainThread;
+
+        ThreadBuffers<ThreadBuffer> buffers;
+    };
+
+    /**
+     * \brief Records a span from construction to destruction. Does nothing if there is no Tracer.
+     */
+    class TraceSpan
+    {
+    public:
+        /**
+         * \brief Start a span.
+         * \param t Tracer, or nullptr if tracing is disabled.
+         * \param spanName Span name. Only copied when the span ends.
+         * \param spanCategory Span category. Must outlive the Tracer, e.g. a string literal.
+         */
+        TraceSpan(Tracer* t, std::string_view spanName, std::string_view spanCategory) noexcept :
+            tracer(t), name(spanName), category(spanCategory), start(t ? t->now() : 0)
+        {
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+
+        TraceSpan(TraceSpan&&) = delete;
+
+        ~TraceSpan() noexcept
+        {
+            if (!tracer) return;
+            try
+            {
+                tracer->record(name, category, start, tracer->now());
+            }
+            catch (...)
+            {
+            }
+        }
+
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+        TraceSpan& operator=(TraceSpan&&) = delete;
+
+    private:
+        Tracer* tracer;
+
+        std::string_view name;
+
+        std::string_view category;
+
+        uint64_t start;
+    };
+}  // namespace bt
@@ -6,6 +6,7 @@
 
 #include <concepts>
 #include <memory>
+#include <utility>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
@@ -60,4 +61,40 @@ namespace bt::type_traits
     template<typename A, typename B, typename C, bool L, bool U>
     concept comparable_between = (comparable_le<A, B> && L || comparable_lt<A, B> && !L) &&
                                  (comparable_le<B, C> && U || comparable_lt<B, C> && !U);
+
+    /**
+     * \brief Associative container that supports key lookup, e.g. std::set, std::map and their unordered variants.
+     */
+    template<typename T>
+    concept associative_container = requires(const T& c, const typename T::key_type& key) {
+        {
+            c.find(key)
+        } -> std::same_as<typename T::const_iterator>;
+        c.equal_range(key);
+    };
+
+    /**
+     * \brief Associative container that maps keys to values, e.g. std::map or std::unordered_map.
+     */
+    template<typename T>
+    concept associative_map = associative_container<T> && requires { typename T::mapped_type; };
+
+    /**
+     * \brief Hash-based associative container, e.g. std::unordered_set or std::unordered_multimap.
+     */
+    template<typename T>
+    concept unordered_container = associative_container<T> && requires {
+        typename T::hasher;
+        typename T::key_equal;
+    };
+
+    /**
+     * \brief Associative container in which keys are unique, i.e. not a multiset or multimap.
+     */
+    template<typename T>
+    concept unique_keys = associative_container<T> && requires(T c, typename T::value_type v) {
+        {
+            c.insert(v)
+        } -> std::same_as<std::pair<typename T::iterator, bool>>;
+    };
 }  // namespace bt::type_traits
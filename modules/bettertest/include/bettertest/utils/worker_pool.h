@@ -0,0 +1,209 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/suite/test_data.h"
+
+namespace bt
+{
+    /**
+     * \brief Type of a frame sent between the coordinator and a worker process. Each frame consists of the type (1
+     * byte), the size of the payload (4 bytes) and the payload.
+     */
+    enum class frame_t : uint8_t
+    {
+        /**
+         * \brief Sent by a worker to ask for a batch of tests. No payload.
+         */
+        request = 0,
+
+        /**
+         * \brief Sent by the coordinator in reply to a request. Payload is a list of runner indices. An empty batch
+         * tells the worker to exit.
+         */
+        batch = 1,
+
+        /**
+         * \brief Sent by a worker for each test it ran. Payload is a WorkerResult.
+         */
+        result = 2
+    };
+
+    /**
+     * \brief Result of a test that ran in a worker process.
+     */
+    struct WorkerResult
+    {
+        /**
+         * \brief Index of the runner of the test.
+         */
+        uint32_t runner = 0;
+
+        bool pass = false;
+
+        failure_t failure = failure_t::none;
+
+        std::chrono::nanoseconds duration{0};
+
+        std::string error;
+
+        std::string output;
+    };
+
+    /**
+     * \brief The WorkerChannel class is one end of a connection between the coordinator and a worker process over a
+     * Unix domain socket. Frames are sent and received in full, so a channel must not be used by more than one thread.
+     */
+    class WorkerChannel
+    {
+    public:
+        WorkerChannel() = default;
+
+        explicit WorkerChannel(int socketFd) noexcept;
+
+        WorkerChannel(const WorkerChannel&) = delete;
+
+        WorkerChannel(WorkerChannel&& other) noexcept;
+
+        ~WorkerChannel() noexcept;
+
+        WorkerChannel& operator=(const WorkerChannel&) = delete;
+
+        WorkerChannel& operator=(WorkerChannel&& other) noexcept;
+
+        /**
+         * \brief Connect to the socket of a coordinator.
+         * \param socket Socket path.
+         * \return Channel, or empty if the connection failed.
+         */
+        [[nodiscard]] static std::optional<WorkerChannel> connect(const std::filesystem::path& socket);
+
+        /**
+         * \brief Send a frame. Blocks until the whole frame was written.
+         * \param type Frame type.
+         * \param payload Payload.
+         * \return True on success, false if the connection was closed.
+         */
+        [[nodiscard]] bool send(frame_t type, std::string_view payload = {}) const;
+
+        /**
+         * \brief Receive a frame. Blocks until a whole frame was read.
+         * \param type Frame type.
+         * \param payload Payload.
+         * \return True on success, false if the connection was closed or the frame is malformed.
+         */
+        [[nodiscard]] bool receive(frame_t& type, std::string& payload) const;
+
+        /**
+         * \brief Wait until a frame arrives or the connection is closed.
+         * \param timeout Maximum time to wait.
+         * \return True if receive will not block, false if the timeout passed first.
+         */
+        [[nodiscard]] bool wait(std::chrono::milliseconds timeout) const;
+
+        /**
+         * \brief Get the process ID of the other end of the connection.
+         * \return Process ID, or empty if it could not be determined.
+         */
+        [[nodiscard]] std::optional<int64_t> getPeerProcess() const;
+
+    private:
+        int fd = -1;
+    };
+
+    /**
+     * \brief The WorkerListener class listens on a Unix domain socket for connections of worker processes. The socket
+     * file is removed when the listener is destroyed.
+     */
+    class WorkerListener
+    {
+    public:
+        WorkerListener() = default;
+
+        WorkerListener(const WorkerListener&) = delete;
+
+        WorkerListener(WorkerListener&&) = delete;
+
+        ~WorkerListener() noexcept;
+
+        WorkerListener& operator=(const WorkerListener&) = delete;
+
+        WorkerListener& operator=(WorkerListener&&) = delete;
+
+        /**
+         * \brief Create a socket in the temporary directory and listen on it.
+         * \return True on success.
+         */
+        [[nodiscard]] bool listen();
+
+        /**
+         * \brief Wait for a worker to connect.
+         * \param timeout Maximum time to wait.
+         * \return Channel, or empty if no worker connected in time.
+         */
+        [[nodiscard]] std::optional<WorkerChannel> accept(std::chrono::milliseconds timeout) const;
+
+        [[nodiscard]] const std::filesystem::path& getSocket() const noexcept { return socket; }
+
+    private:
+        int fd = -1;
+
+        std::filesystem::path socket;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    // Payloads.
+    ////////////////////////////////////////////////////////////////
+
+    [[nodiscard]] std::string encodeBatch(std::span<const uint32_t> runners);
+
+    [[nodiscard]] bool decodeBatch(std::string_view payload, std::vector<uint32_t>& runners);
+
+    [[nodiscard]] std::string encodeResult(const WorkerResult& result);
+
+    [[nodiscard]] bool decodeResult(std::string_view payload, WorkerResult& result);
+
+    ////////////////////////////////////////////////////////////////
+    // Processes.
+    ////////////////////////////////////////////////////////////////
+
+    /**
+     * \brief Returns whether tests can be run in worker processes on this platform.
+     * \return True or false.
+     */
+    [[nodiscard]] bool isWorkerPoolSupported() noexcept;
+
+    /**
+     * \brief Start a worker process running the current executable.
+     * \param arguments Command line arguments, including the program name.
+     * \return Process ID, or empty if the process could not be started.
+     */
+    [[nodiscard]] std::optional<int64_t> spawnWorker(const std::vector<std::string>& arguments);
+
+    /**
+     * \brief Wait for a worker process to exit.
+     * \param pid Process ID.
+     */
+    void waitWorker(int64_t pid) noexcept;
+
+    /**
+     * \brief Terminate a worker process that stopped responding. It must still be waited for.
+     * \param pid Process ID.
+     */
+    void killWorker(int64_t pid) noexcept;
+}  // namespace bt
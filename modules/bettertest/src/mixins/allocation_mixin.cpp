@@ -0,0 +1,81 @@
+#include "bettertest/mixins/allocation_mixin.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::string AllocationMixin::getType() const { return type; }
+
+    ////////////////////////////////////////////////////////////////
+    // Test lifetime.
+    ////////////////////////////////////////////////////////////////
+
+    void AllocationMixin::beginTest()
+    {
+        IMixin::beginTest();
+        testScope = std::make_unique<AllocationScope>();
+    }
+
+    void AllocationMixin::endTest()
+    {
+        if (!testScope)
+        {
+            IMixin::endTest();
+            return;
+        }
+
+        // Release the scope before merging and recording, so that those are not measured.
+        const auto stats = testScope->getStats();
+        testScope.reset();
+        IMixin::endTest();
+
+        if (!isAllocationTrackingAvailable()) return;
+        recordMetric("allocations", static_cast<double>(stats.allocations));
+        recordMetric("bytes", static_cast<double>(stats.bytes));
+        recordMetric("peakLiveBytes", static_cast<double>(stats.peakLiveBytes));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Allocations.
+    ////////////////////////////////////////////////////////////////
+
+    CheckResult AllocationMixin::expectNoAllocations(const std::function<void()>& callable,
+                                                     const std::source_location&  loc)
+    {
+        return expectAllocationsAtMost(0, callable, loc);
+    }
+
+    CheckResult AllocationMixin::expectAllocationsAtMost(const size_t                 n,
+                                                         const std::function<void()>& callable,
+                                                         const std::source_location&  loc)
+    {
+        if (!isAllocationTrackingAvailable())
+            return recordResult(
+              result_t::failure, loc, "Allocation tracking is not available. Enable BETTERTEST_REPLACE_GLOBAL_NEW");
+
+        AllocationStats stats;
+        {
+            const AllocationScope scope;
+            callable();
+            stats = scope.getStats();
+        }
+
+        if (stats.allocations <= n) return recordResult(result_t::success, loc, "");
+
+        return recordResult(
+          result_t::failure,
+          loc,
+          std::format("Expected at most {} allocations, but {} allocations of {} bytes in total were performed",
+                      n,
+                      stats.allocations,
+                      stats.bytes));
+    }
+}  // namespace bt
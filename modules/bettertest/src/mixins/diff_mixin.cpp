@@ -0,0 +1,33 @@
+#include "bettertest/mixins/diff_mixin.h"
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::string DiffMixin::getType() const { return type; }
+
+    ////////////////////////////////////////////////////////////////
+    // Comparisons.
+    ////////////////////////////////////////////////////////////////
+
+    CheckResult
+      DiffMixin::compareTextEQ(const std::string_view lhs, const std::string_view rhs, const std::source_location& loc)
+    {
+        // Cheap size and memcmp check first. Only compute a diff on failure.
+        if (lhs == rhs) return recordResult(result_t::success, loc, "");
+
+        return recordResult(result_t::failure, loc, diffText(lhs, rhs, diffOptions));
+    }
+
+    CheckResult DiffMixin::compareBytesEQ(const std::span<const std::byte> lhs,
+                                          const std::span<const std::byte> rhs,
+                                          const std::source_location&      loc)
+    {
+        if (lhs.size() == rhs.size() && findFirstMismatch(lhs, rhs) == lhs.size())
+            return recordResult(result_t::success, loc, "");
+
+        return recordResult(result_t::failure, loc, diffBytes(lhs, rhs, diffOptions));
+    }
+}  // namespace bt
@@ -4,7 +4,16 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <atomic>
 #include <format>
+#include <iterator>
+
+namespace
+{
+    static_assert(std::atomic_ref<size_t>::required_alignment <= alignof(size_t));
+
+    void increment(size_t& counter) noexcept { std::atomic_ref(counter).fetch_add(1, std::memory_order_relaxed); }
+}  // namespace
 
 namespace bt
 {
@@ -24,14 +33,55 @@ namespace bt
 
     const std::vector<Result>& IMixin::getResults() const noexcept { return results; }
 
+    const std::vector<Metric>& IMixin::getMetrics() const noexcept { return metrics; }
+
     ////////////////////////////////////////////////////////////////
     // Setters.
     ////////////////////////////////////////////////////////////////
 
     void IMixin::setOutput(std::ostream& output) { out = &output; }
 
+    ////////////////////////////////////////////////////////////////
+    // Concurrency.
+    ////////////////////////////////////////////////////////////////
+
+    void IMixin::setConcurrentRecording(const bool concurrent)
+    {
+        if (!concurrent) mergeResults();
+        concurrentRecording = concurrent;
+    }
+
+    bool IMixin::isConcurrentRecording() const noexcept { return concurrentRecording; }
+
+    void IMixin::mergeResults()
+    {
+        // Append results and output of each thread in order of registration.
+        buffers.forEach([this](ThreadBuffer& buffer) {
+            results.insert(results.end(),
+                           std::make_move_iterator(buffer.results.begin()),
+                           std::make_move_iterator(buffer.results.end()));
+            if (out) *out << buffer.output.view();
+        });
+
+        buffers.clear();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Test lifetime.
+    ////////////////////////////////////////////////////////////////
+
+    void IMixin::beginTest() {}
+
+    void IMixin::endTest() { mergeResults(); }
+
+    ////////////////////////////////////////////////////////////////
+    // Recording.
+    ////////////////////////////////////////////////////////////////
+
     CheckResult IMixin::recordResult(const result_t r, const std::source_location& loc, const std::string& error)
     {
+        if (concurrentRecording) return recordResultConcurrent(r, loc, error);
+
         results.emplace_back(r, loc, std::move(error));
 
         // Print failure.
@@ -50,4 +100,26 @@ namespace bt
         default: failures++; return {result_t::failure, *out};
         }
     }
+
+    void IMixin::recordMetric(std::string name, double value) { metrics.emplace_back(std::move(name), value); }
+
+    CheckResult IMixin::recordResultConcurrent(const result_t r, const std::source_location& loc, std::string error)
+    {
+        auto& buffer = buffers.get();
+        auto& res    = buffer.results.emplace_back(r, loc, std::move(error));
+
+        // Print failure to the buffer of this thread. It is written to the actual output when merging.
+        if (r != result_t::success)
+            buffer.output << std::format(
+              "{0}({1}):\n    {2}\n", res.location.file_name(), res.location.line(), res.error);
+
+        increment(total);
+        switch (r)
+        {
+        case result_t::success: increment(successes); return {result_t::success, buffer.output};
+        case result_t::failure: increment(failures); return {result_t::failure, buffer.output};
+        case result_t::exception: increment(exceptions); return {result_t::exception, buffer.output};
+        default: increment(failures); return {result_t::failure, buffer.output};
+        }
+    }
 }  // namespace bt
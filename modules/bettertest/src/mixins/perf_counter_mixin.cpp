@@ -0,0 +1,109 @@
+#include "bettertest/mixins/perf_counter_mixin.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+
+namespace
+{
+    [[nodiscard]] const char* getEventName(const bt::perf_event_t event) noexcept
+    {
+        switch (event)
+        {
+        case bt::perf_event_t::instructions: return "instructions";
+        case bt::perf_event_t::cycles: return "cycles";
+        case bt::perf_event_t::cache_misses: return "cache misses";
+        case bt::perf_event_t::branch_misses: return "branch misses";
+        default: return "events";
+        }
+    }
+}  // namespace
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::string PerfCounterMixin::getType() const { return type; }
+
+    bool PerfCounterMixin::areCountersRequired() const noexcept { return countersRequired; }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void PerfCounterMixin::setCountersRequired(const bool required) noexcept { countersRequired = required; }
+
+    ////////////////////////////////////////////////////////////////
+    // Counters.
+    ////////////////////////////////////////////////////////////////
+
+    PerfCounts PerfCounterMixin::measure(const std::function<void()>& callable, const std::source_location& loc)
+    {
+        PerfCounts counts;
+        {
+            PerfCounters counters;
+            counters.start();
+            callable();
+            counts = counters.stop();
+        }
+
+        const auto record = [&](const char* name, const std::optional<uint64_t>& value) {
+            if (value) recordMetric(std::format("{}:{}", name, loc.line()), static_cast<double>(*value));
+        };
+        record("instructions", counts.instructions);
+        record("cycles", counts.cycles);
+        record("cacheMisses", counts.cacheMisses);
+        record("branchMisses", counts.branchMisses);
+        record("taskClock", counts.taskClock);
+
+        return counts;
+    }
+
+    CheckResult PerfCounterMixin::expectInstructionsAtMost(const uint64_t                n,
+                                                           const std::function<void()>& callable,
+                                                           const std::source_location&  loc)
+    {
+        return expectEventAtMost(perf_event_t::instructions, n, callable, loc);
+    }
+
+    CheckResult PerfCounterMixin::expectCacheMissesAtMost(const uint64_t                n,
+                                                          const std::function<void()>& callable,
+                                                          const std::source_location&  loc)
+    {
+        return expectEventAtMost(perf_event_t::cache_misses, n, callable, loc);
+    }
+
+    CheckResult PerfCounterMixin::expectBranchMissesAtMost(const uint64_t                n,
+                                                           const std::function<void()>& callable,
+                                                           const std::source_location&  loc)
+    {
+        return expectEventAtMost(perf_event_t::branch_misses, n, callable, loc);
+    }
+
+    CheckResult PerfCounterMixin::expectEventAtMost(const perf_event_t           event,
+                                                    const uint64_t               n,
+                                                    const std::function<void()>& callable,
+                                                    const std::source_location&  loc)
+    {
+        const auto count = measure(callable, loc).get(event);
+
+        // Counters are not permitted, not supported or were not scheduled. The budget could not be checked, which is
+        // recorded with the result, but only fails the test if counters are required.
+        if (!count)
+            return recordResult(countersRequired ? result_t::failure : result_t::success,
+                                loc,
+                                std::format("Counter unavailable: could not measure {}. Check perf_event_paranoid or "
+                                            "the permissions of the container",
+                                            getEventName(event)));
+
+        if (*count <= n) return recordResult(result_t::success, loc, "");
+
+        return recordResult(result_t::failure,
+                            loc,
+                            std::format("Expected at most {} {}, but measured {}", n, getEventName(event), *count));
+    }
+}  // namespace bt
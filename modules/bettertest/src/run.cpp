@@ -19,6 +19,7 @@
 ////////////////////////////////////////////////////////////////
 
 #include "bettertest/exceptions/better_test_error.h"
+#include "bettertest/utils/worker_pool.h"
 
 namespace bt::internal
 {
@@ -85,6 +86,28 @@ namespace bt::internal
         const auto format = parser.add_value<std::string>('\0', "format");
         format->set_default("json");
 
+        const auto isolate = parser.add_flag('i', "isolate");
+        isolate->set_help("Run each unit test in a separate process.",
+                          "If this flag is enabled, each unit test runs in a child process, so that a crash or "
+                          "exceeded resource limit does not affect other tests. Only supported on Linux. See "
+                          "--limit-cpu, --limit-files, --limit-memory and --limit-time.");
+
+        const auto limitCpu = parser.add_value<uint64_t>('\0', "limit-cpu");
+        limitCpu->set_help("CPU time limit of isolated unit tests in seconds.");
+
+        const auto limitFiles = parser.add_value<uint64_t>('\0', "limit-files");
+        limitFiles->set_help("Number of files isolated unit tests may open.");
+
+        const auto limitMemory = parser.add_value<uint64_t>('\0', "limit-memory");
+        limitMemory->set_help("Memory limit of isolated unit tests in MiB.",
+                              "Limits the address space the test may map in addition to what the process already "
+                              "uses. Tests that exceed it are reported as failing with a memory limit error.");
+
+        const auto limitTime = parser.add_value<uint64_t>('\0', "limit-time");
+        limitTime->set_help("Wall-clock time limit of isolated unit tests in seconds.",
+                            "Tests that do not finish in time are killed and reported as failing with a time limit "
+                            "error. Defaults to 600 seconds.");
+
         const auto multithreaded = parser.add_flag('m', "multithreaded");
         multithreaded->set_help("Run tests in parallel.");
 
@@ -92,9 +115,29 @@ namespace bt::internal
         outdir->set_default(std::filesystem::current_path() / (suite.getName() + std::string(".dir")));
         outdir->set_help("Path to directory in which test data is stored.");
 
-        /*auto performance = parser.add_list<std::string>('p', "performance");
+        const auto performance = parser.add_list<std::string>('p', "performance");
         performance->set_help(
-          "List of name patterns. Only performance tests whose name matches one of the patterns is run.");*/
+          "List of name patterns. Only performance tests whose name matches one of the patterns is run.");
+
+        const auto profile = parser.add_flag('\0', "profile");
+        profile->set_help("Profile performance tests.",
+                          "If this flag is enabled, the call stacks of performance tests are sampled while measuring "
+                          "and written in the folded stack format to <outdir>/<test>.folded. Compile with "
+                          "-fno-omit-frame-pointer to get complete stacks and link with -rdynamic to resolve the "
+                          "names of functions in the executable.");
+
+        const auto strictEnvironment = parser.add_flag('\0', "strict-environment");
+        strictEnvironment->set_help("Do not run performance tests in an unfit environment.",
+                                    "If this flag is enabled, performance tests are not run and the suite fails when "
+                                    "the CPU cannot be pinned, frequency scaling or turbo boost is enabled, or the "
+                                    "system is busy. Without it, frequency scaling and turbo boost only print a "
+                                    "warning.");
+
+        const auto trace = parser.add_value<std::filesystem::path>('\0', "trace");
+        trace->set_help("Path to a file to which a trace of the run is written.",
+                        "If set, the time spent in each phase of the suite and in each test is recorded together with "
+                        "the thread it ran on, and written in the Chrome trace event format, which can be opened in "
+                        "Perfetto or chrome://tracing.");
 
         const auto unit = parser.add_list<std::string>('u', "unit");
         unit->set_help("List of name patterns. Only unit tests whose name matches one of the patterns is run.");
@@ -102,6 +145,15 @@ namespace bt::internal
         const auto verbose = parser.add_flag('\0', "verbose");
         verbose->set_help("");
 
+        const auto worker = parser.add_value<std::filesystem::path>('\0', "worker");
+        worker->set_help("Internal. Run as a worker process connected to this socket.");
+
+        const auto workers = parser.add_value<uint64_t>('w', "workers");
+        workers->set_help("Run unit tests in a pool of worker processes.",
+                          "If set, unit tests that can run in parallel are run by this number of long-lived worker "
+                          "processes instead of threads. The workers run this executable again, connect back over a "
+                          "Unix domain socket and pull tests in batches. Only supported on Linux.");
+
         ////////////////////////////////////////////////////////////////
         // Run.
         ////////////////////////////////////////////////////////////////
@@ -167,11 +219,49 @@ namespace bt::internal
         // Enable multithreading.
         if (multithreaded->is_set()) suite.setMultithreaded(true);
 
-        // performance
+        // Run unit tests in isolated processes.
+        if (isolate->is_set())
+        {
+            if (!isIsolationSupported())
+                std::cout << "Isolated tests are not supported on this platform. Running in a single process."
+                          << std::endl;
+            suite.setIsolated(true);
+
+            ResourceLimits limits;
+            if (limitCpu->is_set()) limits.cpuSeconds = limitCpu->get_value();
+            if (limitFiles->is_set()) limits.openFiles = limitFiles->get_value();
+            if (limitMemory->is_set()) limits.memory = limitMemory->get_value() * 1024 * 1024;
+            if (limitTime->is_set()) limits.wallSeconds = limitTime->get_value();
+            suite.setResourceLimits(limits);
+        }
+
+        // Pass performance test filter to test suite.
+        if (performance->is_set()) suite.setPerformanceTestFilter(performance->get_values());
+
+        // Sample call stacks of performance tests.
+        if (profile->is_set()) suite.setProfiling(true);
+
+        // Refuse to run performance tests in an unfit environment.
+        if (strictEnvironment->is_set()) suite.setStrictEnvironment(true);
+
+        // Record a trace of the run. Workers do not write a trace of their own.
+        if (trace->is_set() && !worker->is_set()) suite.setTraceFile(trace->get_value());
 
         // Pass unit test filter to test suite.
         if (unit->is_set()) suite.setUnitTestFilter(unit->get_values());
 
+        // Run as a worker of another process, or start a pool of workers.
+        if (worker->is_set())
+            suite.setWorkerSocket(worker->get_value());
+        else if (workers->is_set() && workers->get_value() > 0)
+        {
+            if (isWorkerPoolSupported())
+                suite.setWorkers(workers->get_value(), std::vector<std::string>(argv, argv + argc));
+            else
+                std::cout << "Worker processes are not supported on this platform. Running in a single process."
+                          << std::endl;
+        }
+
         // verbose
 
         return true;
@@ -0,0 +1,146 @@
+#include "bettertest/suite/performance_test_data.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <ranges>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/suite/suite_data.h"
+#include "bettertest/suite/test_suite.h"
+#include "bettertest/utils/histogram.h"
+#include "bettertest/utils/regression.h"
+
+namespace bt
+{
+    PerformanceTestData::PerformanceTestData(const TestData& other) : TestData(other) {}
+
+    std::string PerformanceTestData::getType() const { return type; }
+
+    bool PerformanceTestData::addResults(const TestSuite&        suite,
+                                         const BenchmarkResults& results,
+                                         const BenchmarkOptions& options,
+                                         std::ostream&           out)
+    {
+        // Compare rates of the metric counter if there is one, times otherwise.
+        const auto& name    = options.regressionMetric;
+        const auto* counter = name.empty() ? nullptr : findCounter(results, name);
+        const auto& samples = counter ? counter->rates : results.samples;
+        const auto  metric  = counter ? counter->name : std::string{};
+        if (!name.empty() && !counter)
+            out << std::format("    Comparing times, because there is no counter \"{}\"\n", name);
+
+        const auto sameKey = [&](const Run& run) {
+            return run.argument == results.argument && run.threads == results.threads && run.cache == results.cache &&
+                   run.metric == metric;
+        };
+        const auto stable = !results.throttled && suite.getData().environment.isFit();
+
+        // Pool the samples of the most recent stable runs.
+        std::vector<double> baseline;
+        size_t              runs = 0;
+        for (auto it = history.rbegin(); it != history.rend() && runs < options.baselineRuns; ++it)
+        {
+            if (!sameKey(*it) || !it->stable) continue;
+            baseline.insert(baseline.end(), it->samples.begin(), it->samples.end());
+            runs++;
+        }
+
+        auto pass = true;
+        if (!stable)
+            out << "    Not compared to previous runs, because the environment was unstable\n";
+        else if (!baseline.empty() && !samples.empty())
+        {
+            const auto r = detectRegression(samples, baseline, options, counter != nullptr);
+            if (counter)
+                out << std::format("    {} rate {:+.1f}% compared to {} previous runs (p = {:.4f})\n",
+                                   metric,
+                                   -r.shift * 100,
+                                   runs,
+                                   r.p);
+            else
+                out << std::format(
+                  "    {:+.1f}% compared to {} previous runs (p = {:.4f})\n", r.shift * 100, runs, r.p);
+            if (r.regression)
+            {
+                out << std::format("    Regression: slower by more than {:.1f}%\n", options.regressionThreshold * 100);
+                pass = false;
+            }
+        }
+
+        // Report the change of tail latencies against the most recent stable run with a histogram.
+        const auto previous = std::ranges::find_if(history.rbegin(), history.rend(), [&](const Run& run) {
+            return sameKey(run) && run.stable && !run.histogram.empty();
+        });
+        if (stable && results.distribution && previous != history.rend())
+        {
+            if (const auto h = Histogram::decode(previous->histogram); h && h->getTotalCount() > 0)
+            {
+                const auto change = [&](const double current, const double percentile) {
+                    const auto before = static_cast<double>(h->getValueAtPercentile(percentile));
+                    return before > 0 ? (current - before) / before * 100 : 0.0;
+                };
+                out << std::format("    p99 {:+.1f}% | p99.9 {:+.1f}% | p99.99 {:+.1f}% compared to previous run\n",
+                                   change(results.distribution->p99, 99),
+                                   change(results.distribution->p999, 99.9),
+                                   change(results.distribution->p9999, 99.99));
+            }
+        }
+
+        // Add run and drop runs that are no longer part of any baseline.
+        history.emplace_back(suite.getData().runIndex,
+                             results.argument,
+                             results.threads,
+                             results.cache,
+                             metric,
+                             samples,
+                             results.distribution ? results.distribution->histogram : std::string{},
+                             stable);
+        // Stable and unstable runs are capped separately, so that unstable runs do not push stable runs out of the
+        // baseline.
+        for (const auto keepStable : {true, false})
+        {
+            // Runs are appended in order, so the first matching runs are the oldest.
+            std::vector<size_t> runs;
+            for (size_t i = 0; i < history.size(); i++)
+                if (sameKey(history[i]) && history[i].stable == keepStable) runs.emplace_back(i);
+            if (runs.size() <= options.baselineRuns) continue;
+            runs.resize(runs.size() - options.baselineRuns);
+
+            // Erase from back to front, so that the remaining indices stay valid.
+            for (const auto i : std::views::reverse(runs)) history.erase(history.begin() + static_cast<ptrdiff_t>(i));
+        }
+
+        return pass;
+    }
+
+    PerformanceTestData* findPerformanceTestData(const TestSuite& suite, const std::string& name)
+    {
+        const auto& data = suite.getPerformanceTestSuite().getData();
+        const auto  it   = std::ranges::find_if(data, [&name](const TestDataPtr& t) { return t->name == name; });
+        if (it == data.end()) return nullptr;
+        return dynamic_cast<PerformanceTestData*>(it->get());
+    }
+
+    std::optional<std::filesystem::path> getProfilePath(const TestSuite& suite, const std::string& name)
+    {
+        if (!suite.getPerformanceTestSuite().isProfiling()) return std::nullopt;
+
+        // Test names can contain namespaces and template arguments.
+        auto file = name;
+        std::ranges::replace_if(
+          file, [](const char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-'; }, '_');
+
+        std::error_code ec;
+        std::filesystem::create_directories(suite.getOutputDirectory(), ec);
+        return suite.getOutputDirectory() / (file + ".folded");
+    }
+}  // namespace bt
@@ -5,78 +5,210 @@
 ////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <chrono>
+#include <format>
+#include <ranges>
+#include <sstream>
 #include <string>
 
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "common/ansi_colors.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/output/exporter_interface.h"
+#include "bettertest/suite/performance_test_data.h"
+#include "bettertest/suite/suite_data.h"
+#include "bettertest/suite/test_suite.h"
+#include "bettertest/utils/benchmark.h"
+#include "bettertest/utils/environment.h"
+#include "bettertest/utils/timer.h"
+#include "bettertest/utils/trace.h"
+
 using namespace std::string_literals;
 
+namespace
+{
+    void printResults(std::ostream& out, const std::stringstream& ss, const bool pass, const bt::ITestRunner& runner)
+    {
+        const auto s = ss.str();
+        if (pass)
+            out << ansi_color::fg_black << ansi_color::bg_brightgreen;
+        else
+            out << ansi_color::fg_black << ansi_color::bg_brightred;
+        out << "[ START " << runner.getTestName() << " ]\n";
+        out << ansi_color::fg_white << ansi_color::bg_black;
+        out << s;
+        if (pass)
+            out << ansi_color::fg_black << ansi_color::bg_brightgreen;
+        else
+            out << ansi_color::fg_black << ansi_color::bg_brightred;
+        out << "[ END   " << runner.getTestName() << " ]\n";
+        out << ansi_color::fg_white << ansi_color::bg_black << std::endl;
+    }
+}  // namespace
+
 namespace bt
 {
+    ////////////////////////////////////////////////////////////////
+    // Initialization.
+    ////////////////////////////////////////////////////////////////
+
     void PerformanceTestSuite::addTest(ITestRunnerPtr runner) { runners.emplace_back(std::move(runner)); }
 
     void PerformanceTestSuite::setFilter(const std::vector<std::string>& filters) { filter.addFilters(filters); }
 
-    void PerformanceTestSuite::setRunFailingOnly(const bool run) noexcept { runFailingOnly = run; }
+    void PerformanceTestSuite::setRunFailingOnly(const bool failingOnly) noexcept { runFailingOnly = failingOnly; }
+
+    void PerformanceTestSuite::setStrictEnvironment(const bool strict) noexcept { strictEnvironment = strict; }
 
-    void PerformanceTestSuite::operator()()
+    void PerformanceTestSuite::setProfiling(const bool enabled) noexcept { profiling = enabled; }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    auto PerformanceTestSuite::getData() noexcept -> TestDataList& { return data; }
+
+    auto PerformanceTestSuite::getData() const noexcept -> const TestDataList& { return data; }
+
+    bool PerformanceTestSuite::isPassing() const noexcept
     {
-        // Access this to shut up static analysis for now.
-        static_cast<void>(this);
-#if 0
-        resolveTests();
+        if (refused) return false;
 
-        for (auto& test : data)
-        {
-            // Skip tests without a runner.
-            if (test->runnerIndex >= runners.size()) continue;
+        return std::ranges::all_of(
+          data.begin(), data.end(), [](const auto& t) { return !t->hasRunnerIndex() || t->passing; });
+    }
 
-            auto& runner = runners[test->runnerIndex];
+    bool PerformanceTestSuite::isProfiling() const noexcept { return profiling; }
 
-            // Skip tests that don't match the name pattern.
-            if (!filter.match(runner->getTestName(), true)) continue;
+    ////////////////////////////////////////////////////////////////
+    // Run.
+    ////////////////////////////////////////////////////////////////
 
-            // Skip non-failing tests.
-            if (runFailingOnly && test->passing) continue;
+    void PerformanceTestSuite::operator()(const TestSuite& suite, IExporter& exporter, std::ostream& out)
+    {
+        // Nothing to report for suites without performance tests.
+        if (runners.empty()) return;
 
-            // Run test.
-            //results[runner->getTestName()] = {};
-            //test.passing                   = (*runner)(results[runner->getTestName()]);
+        // Pin to a single CPU for the whole phase, so that the scheduler does not migrate tests between CPUs.
+        const CpuPinning pinning;
+        auto&            environment = suite.getData().environment;
+        environment                  = inspectEnvironment(pinning);
+
+        // Warnings only make the environment unfit in strict mode.
+        const auto fit = strictEnvironment ? environment.isStrictlyFit() : environment.isFit();
+        if (!fit)
+        {
+            out << ansi_color::fg_black << ansi_color::bg_brightyellow << "Environment is unfit for benchmarking:"
+                << ansi_color::fg_white << ansi_color::bg_black << "\n";
+            for (const auto& error : environment.errors) out << "    " << error << "\n";
+            for (const auto& warning : environment.warnings) out << "    " << warning << "\n";
+
+            if (strictEnvironment)
+            {
+                out << "Not running performance tests\n\n";
+                refused = true;
+                return;
+            }
+
+            out << "Results are not compared to previous runs\n\n";
+        }
+        else
+        {
+            out << "Running performance tests on CPU " << environment.cpu << (environment.isolated ? " (isolated)" : "")
+                << "\n";
+            for (const auto& warning : environment.warnings) out << "    Warning: " << warning << "\n";
         }
-#endif
-    }
 
-    auto PerformanceTestSuite::getData() noexcept -> TestData_t& { return data; }
+        // Select and calibrate the timer before any test runs.
+        const auto& timer = Timer::get();
+        out << std::format("Timer {} at {:.3f} GHz, overhead {} ticks, pause overhead {} ticks\n",
+                           timer.getName(),
+                           timer.getTicksPerNanosecond(),
+                           timer.getOverhead(),
+                           getPauseOverhead());
 
-    auto PerformanceTestSuite::getData() const noexcept -> const TestData_t& { return data; }
+        {
+            const TraceSpan span(suite.getTracer(), "resolve performance tests", "suite");
+            resolveTests(suite, out);
+        }
+        runTests(suite, exporter, out);
+    }
 
-    void PerformanceTestSuite::resolveTests()
+    void PerformanceTestSuite::resolveTests(const TestSuite& suite, std::ostream& out)
     {
-        // Access this to shut up static analysis for now.
-        static_cast<void>(this);
-#if 0
-        // Detect added and deleted tests.
+        size_t testCount = 0;
+
+        // Create and initialize tests.
         for (size_t i = 0; i < runners.size(); i++)
         {
             const auto& runner = runners[i];
 
-            // Look for test.
-            const auto testName = runner->getTestName();
-            auto       it =
-              std::find_if(tests.begin(), tests.end(), [&testName](const TestState& t) { return t.name == testName; });
+            // Disable tests that do not match pattern.
+            const auto& testName = runner->getTestName();
+            if (!filter.match(testName, true)) continue;
 
-            // Found test, set runner index.
-            if (it != tests.end())
+            // Found test, initialize.
+            if (const auto it =
+                  std::ranges::find_if(data, [&testName](const TestDataPtr& t) { return t->name == testName; });
+                it != data.end())
             {
-                it->state       = TestState::State::Unchanged;
-                it->runnerIndex = i;
-                continue;
+                // Skip non-failing tests.
+                if (runFailingOnly && (*it)->passing) continue;
+
+                // Upgrade data that was stored without history.
+                if (!dynamic_cast<PerformanceTestData*>(it->get()))
+                    *it = std::make_unique<PerformanceTestData>(**it);
+
+                (*it)->initialize(suite, i);
             }
+            // Did not find test, create new and then initialize.
+            else
+            {
+                const auto& t = data.emplace_back(std::make_unique<PerformanceTestData>());
+                t->create(suite, testName);
+                t->initialize(suite, i);
+            }
+
+            testCount++;
+        }
+
+        out << "Running " << testCount << "/" << runners.size() << " performance tests\n\n";
+    }
+
+    void PerformanceTestSuite::runTests(const TestSuite& suite, IExporter& exporter, std::ostream& out) const
+    {
+        for (const auto& testData : data)
+        {
+            // Skip tests without a runner.
+            if (!testData->hasRunnerIndex()) continue;
+
+            auto& runner = *runners[testData->runnerIndex];
+
+            // Run test.
+            const TraceSpan   span(suite.getTracer(), runner.getTestName(), "performance");
+            std::stringstream ss;
+
+            const auto start         = std::chrono::steady_clock::now();
+            const auto [pass, error] = runner(suite, exporter, ss);
+            const auto end           = std::chrono::steady_clock::now();
+
+            // If test failed due to an exception, output error message.
+            if (!pass && !error.empty()) ss << "The following error occurred:\n" << error << "\n";
+
+            // Finalize test data.
+            testData->duration = end - start;
+            testData->failure  = pass ? failure_t::none : failure_t::failed;
+            testData->finalize(suite, pass);
 
-            // Did not find test, create new test state.
-            auto& t       = tests.emplace_back();
-            t.name        = testName;
-            t.state       = TestState::State::Added;
-            t.runnerIndex = i;
+            // Print output.
+            printResults(out, ss, pass, runner);
         }
-#endif
     }
 }  // namespace bt
@@ -5,7 +5,6 @@
 ////////////////////////////////////////////////////////////////
 
 #include "bettertest/suite/test_suite.h"
-#include "bettertest/utils/date.h"
 
 namespace bt
 {
@@ -13,7 +12,7 @@ namespace bt
 
     void SuiteData::create(TestSuite& suite)
     {
-        dateCreated = dateTimeAsString();
+        dateCreated = std::chrono::system_clock::now();
         name        = suite.getName();
         runIndex    = 0;
         version     = Version::create();
@@ -21,7 +20,7 @@ namespace bt
 
     void SuiteData::initialize(TestSuite& suite)
     {
-        dateLastRun = dateTimeAsString();
+        dateLastRun = std::chrono::system_clock::now();
         runIndex++;
         static_cast<void>(suite);
     }
@@ -5,7 +5,6 @@
 ////////////////////////////////////////////////////////////////
 
 #include "bettertest/suite/test_suite.h"
-#include "bettertest/utils/date.h"
 
 namespace bt
 {
@@ -13,7 +12,7 @@ namespace bt
 
     void TestData::create(const TestSuite& suite, std::string testName)
     {
-        dateCreated = dateTimeAsString();
+        dateCreated = std::chrono::system_clock::now();
         name        = std::move(testName);
         static_cast<void>(suite);
     }
@@ -21,7 +20,7 @@ namespace bt
     void TestData::initialize(const TestSuite& suite, const size_t index)
     {
         runnerIndex = index;
-        dateLastRun = dateTimeAsString();
+        dateLastRun = std::chrono::system_clock::now();
         static_cast<void>(suite);
     }
 
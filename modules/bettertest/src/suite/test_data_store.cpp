@@ -0,0 +1,156 @@
+#include "bettertest/suite/test_data_store.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <typeinfo>
+
+namespace
+{
+    /**
+     * \brief Size of a block of the name table. Longer names get a block of their own.
+     */
+    constexpr size_t nameBlockSize = 64 * 1024;
+
+    /**
+     * \brief Value of the runner column for tests without a runner.
+     */
+    constexpr uint32_t noRunner = static_cast<uint32_t>(-1);
+}  // namespace
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // Conversion.
+    ////////////////////////////////////////////////////////////////
+
+    bool TestDataStore::canStore(const std::vector<TestDataPtr>& list) noexcept
+    {
+        return std::ranges::all_of(list, [](const TestDataPtr& t) { return typeid(*t) == typeid(TestData); });
+    }
+
+    void TestDataStore::assign(const std::vector<TestDataPtr>& list)
+    {
+        clear();
+        for (const auto& t : list)
+        {
+            const auto i = add(t->name, t->dateCreated);
+            lastRun[i]   = t->dateLastRun;
+            durations[i] = t->duration;
+            failures[i]  = t->failure;
+            if (t->passing) flags[i] |= passing;
+            if (t->hasRunnerIndex())
+            {
+                flags[i] |= active;
+                runners[i] = static_cast<uint32_t>(t->runnerIndex);
+            }
+        }
+    }
+
+    std::vector<TestDataPtr> TestDataStore::toTestData() const
+    {
+        std::vector<TestDataPtr> list;
+        list.reserve(size());
+        for (size_t i = 0; i < size(); i++)
+        {
+            auto& t        = list.emplace_back(std::make_unique<TestData>());
+            t->name        = std::string(names[i]);
+            t->dateCreated = created[i];
+            t->dateLastRun = lastRun[i];
+            t->duration    = durations[i];
+            t->passing     = isPassing(i);
+            t->failure     = failures[i];
+            if (hasRunnerIndex(i)) t->runnerIndex = runners[i];
+        }
+        return list;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Records.
+    ////////////////////////////////////////////////////////////////
+
+    std::optional<size_t> TestDataStore::find(const std::string_view name) const
+    {
+        const auto it = lookup.find(name);
+        if (it == lookup.end()) return std::nullopt;
+        return it->second;
+    }
+
+    size_t TestDataStore::add(const std::string_view name, const date_time_t date)
+    {
+        const auto i = names.size();
+        const auto n = intern(name);
+        lookup.emplace(n, static_cast<uint32_t>(i));
+        names.emplace_back(n);
+        flags.emplace_back(uint8_t{0});
+        runners.emplace_back(noRunner);
+        created.emplace_back(date);
+        lastRun.emplace_back();
+        durations.emplace_back();
+        failures.emplace_back(failure_t::none);
+        return i;
+    }
+
+    void TestDataStore::initialize(const size_t i, const size_t runner, const date_time_t time) noexcept
+    {
+        flags[i] |= active;
+        runners[i] = static_cast<uint32_t>(runner);
+        lastRun[i] = time;
+    }
+
+    void TestDataStore::finalize(const size_t                   i,
+                                 const bool                     pass,
+                                 const std::chrono::nanoseconds duration,
+                                 const failure_t                failure) noexcept
+    {
+        flags[i]     = static_cast<uint8_t>(pass ? flags[i] | passing : flags[i] & ~passing);
+        durations[i] = duration;
+        failures[i]  = failure;
+    }
+
+    void TestDataStore::clear() noexcept
+    {
+        blocks.clear();
+        blockUsed = 0;
+        blockSize = 0;
+        lookup.clear();
+        names.clear();
+        flags.clear();
+        runners.clear();
+        created.clear();
+        lastRun.clear();
+        durations.clear();
+        failures.clear();
+    }
+
+    std::string_view TestDataStore::intern(const std::string_view name)
+    {
+        // Empty names need no storage, and there may not be a block yet.
+        if (name.empty()) return {};
+
+        if (blockSize - blockUsed < name.size())
+        {
+            blockSize = std::max(nameBlockSize, name.size());
+            blockUsed = 0;
+            blocks.emplace_back(std::make_unique_for_overwrite<char[]>(blockSize));
+        }
+
+        auto* data = blocks.back().get() + blockUsed;
+        std::memcpy(data, name.data(), name.size());
+        blockUsed += name.size();
+        return {data, name.size()};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    bool TestDataStore::allPassing() const noexcept
+    {
+        return std::ranges::all_of(flags, [](const uint8_t f) { return !(f & active) || (f & passing); });
+    }
+}  // namespace bt
@@ -59,14 +59,39 @@ namespace bt
 
     void TestSuite::setMultithreaded(const bool multiThreaded) { unitTestSuite.setMultithreaded(multiThreaded); }
 
+    void TestSuite::setIsolated(const bool isolate) { unitTestSuite.setIsolated(isolate); }
+
+    void TestSuite::setResourceLimits(const ResourceLimits& limits) { unitTestSuite.setResourceLimits(limits); }
+
+    void TestSuite::setWorkers(const size_t count, std::vector<std::string> command)
+    {
+        unitTestSuite.setWorkers(count, std::move(command));
+    }
+
+    void TestSuite::setWorkerSocket(std::filesystem::path socket) { workerSocket = std::move(socket); }
+
+    void TestSuite::setStrictEnvironment(const bool strict) { performanceTestSuite.setStrictEnvironment(strict); }
+
+    void TestSuite::setProfiling(const bool enabled) { performanceTestSuite.setProfiling(enabled); }
+
+    void TestSuite::setTraceFile(std::filesystem::path file)
+    {
+        traceFile = std::move(file);
+        tracer    = traceFile.empty() ? nullptr : std::make_unique<Tracer>();
+    }
+
     ////////////////////////////////////////////////////////////////
     // Getters.
     ////////////////////////////////////////////////////////////////
 
     const std::string& TestSuite::getName() const noexcept { return name; }
 
+    const std::filesystem::path& TestSuite::getOutputDirectory() const noexcept { return path; }
+
     SuiteData& TestSuite::getData() const noexcept { return *data; }
 
+    Tracer* TestSuite::getTracer() const noexcept { return tracer.get(); }
+
     const UnitTestSuite& TestSuite::getUnitTestSuite() const noexcept { return unitTestSuite; }
 
     UnitTestSuite& TestSuite::getUnitTestSuite() noexcept { return unitTestSuite; }
@@ -81,8 +106,15 @@ namespace bt
 
     void TestSuite::operator()()
     {
+        if (!workerSocket.empty())
+        {
+            runWorker();
+            return;
+        }
+
         // Try to read suite file. If it did not exist, create default suite data object.
         {
+            const TraceSpan span(tracer.get(), "import", "suite");
             if (const auto imp = importer(path); !imp->readSuite(*this)) data->create(*this);
         }
 
@@ -92,13 +124,35 @@ namespace bt
         const auto exp = exporter(path);
 
         // Run unit test suite.
-        unitTestSuite(*this, *exp, std::cout);
+        {
+            const TraceSpan span(tracer.get(), "unit tests", "suite");
+            unitTestSuite(*this, *exp, std::cout);
+        }
+
+        // Run performance test suite. All unit tests have finished at this point, including those that ran in parallel,
+        // so nothing else is running in this process while measuring.
+        {
+            const TraceSpan span(tracer.get(), "performance tests", "suite");
+            performanceTestSuite(*this, *exp, std::cout);
+        }
 
         // Finalize suite data.
-        data->finalize(*this, unitTestSuite.isPassing());
+        data->finalize(*this, unitTestSuite.isPassing() && performanceTestSuite.isPassing());
 
         // Write suite file.
-        exp->writeSuite(*this);
+        {
+            const TraceSpan span(tracer.get(), "export", "suite");
+            exp->writeSuite(*this);
+        }
+
+        // Write trace after all spans have ended.
+        if (tracer)
+        {
+            if (tracer->write(traceFile))
+                std::cout << "Trace written to " << traceFile.string() << "\n";
+            else
+                std::cout << "Could not write trace to " << traceFile.string() << "\n";
+        }
 
         std::cout << std::endl;
 
@@ -115,4 +169,14 @@ namespace bt
 
         std::cout << ansi_color::fg_white << ansi_color::bg_black;
     }
+
+    void TestSuite::runWorker()
+    {
+        // Read the suite, so that exporters writing test results see the same suite data as the coordinator.
+        if (const auto imp = importer(path); !imp->readSuite(*this)) data->create(*this);
+        data->initialize(*this);
+
+        const auto exp = exporter(path);
+        data->finalize(*this, unitTestSuite.runWorker(*this, *exp, workerSocket));
+    }
 }  // namespace bt
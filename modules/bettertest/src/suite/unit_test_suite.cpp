@@ -5,6 +5,9 @@
 ////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <chrono>
+#include <deque>
+#include <format>
 #include <future>
 #include <mutex>
 #include <ranges>
@@ -22,11 +25,35 @@
 
 #include "bettertest/output/exporter_interface.h"
 #include "bettertest/suite/test_suite.h"
+#include "bettertest/utils/trace.h"
+#include "bettertest/utils/worker_pool.h"
 
 using namespace std::string_literals;
 
 namespace
 {
+    /**
+     * \brief Maximum time to wait for a worker process to connect.
+     */
+    constexpr std::chrono::seconds workerConnectTimeout(10);
+
+    /**
+     * \brief Maximum number of tests sent to a worker at once.
+     */
+    constexpr size_t maxBatchSize = 64;
+
+    /**
+     * \brief Get the number of tests to send to a worker. Batches shrink as the queue drains, so that all workers
+     * finish at about the same time.
+     * \param remaining Number of tests in the queue.
+     * \param workers Number of workers.
+     * \return Batch size.
+     */
+    [[nodiscard]] size_t getBatchSize(const size_t remaining, const size_t workers) noexcept
+    {
+        return std::min(remaining, std::clamp<size_t>(remaining / (workers * 4), 1, maxBatchSize));
+    }
+
     void printResults(std::ostream& out, const std::stringstream& ss, const bool pass, const bt::ITestRunner& runner)
     {
         const auto s = ss.str();
@@ -60,16 +87,51 @@ namespace bt
 
     void UnitTestSuite::setMultithreaded(const bool multiThread) { multiThreaded = multiThread; }
 
+    void UnitTestSuite::setIsolated(const bool isolate) noexcept { isolated = isolate; }
+
+    void UnitTestSuite::setResourceLimits(const ResourceLimits& resourceLimits) noexcept { limits = resourceLimits; }
+
+    void UnitTestSuite::setWorkers(const size_t count, std::vector<std::string> command)
+    {
+        workerCount   = count;
+        workerCommand = std::move(command);
+    }
+
     ////////////////////////////////////////////////////////////////
     // Getters.
     ////////////////////////////////////////////////////////////////
 
-    auto UnitTestSuite::getData() noexcept -> TestDataList& { return data; }
+    auto UnitTestSuite::getData() -> TestDataList&
+    {
+        // The caller can modify the list, so it replaces the store until the next run.
+        if (columnar)
+        {
+            data = store.toTestData();
+            store.clear();
+            columnar     = false;
+            materialized = false;
+        }
+        return data;
+    }
+
+    auto UnitTestSuite::getData() const -> const TestDataList&
+    {
+        std::scoped_lock lock(dataMutex);
+        if (columnar && !materialized)
+        {
+            data         = store.toTestData();
+            materialized = true;
+        }
+        return data;
+    }
+
+    bool UnitTestSuite::isColumnar() const noexcept { return columnar; }
 
-    auto UnitTestSuite::getData() const noexcept -> const TestDataList& { return data; }
+    const TestDataStore& UnitTestSuite::getStore() const noexcept { return store; }
 
     bool UnitTestSuite::isPassing() const noexcept
     {
+        if (columnar) return store.allPassing();
         return std::ranges::all_of(
           data.begin(), data.end(), [](const auto& t) { return !t->hasRunnerIndex() || t->passing; });
     }
@@ -80,12 +142,76 @@ namespace bt
 
     void UnitTestSuite::operator()(const TestSuite& suite, IExporter& exporter, std::ostream& out)
     {
-        resolveTests(suite, out);
-        if (multiThreaded) runTestsMultithreaded(suite, exporter, out);
-        runTestsSerialized(suite, exporter, out);
+        {
+            const TraceSpan span(suite.getTracer(), "resolve tests", "suite");
+            resolveTests(suite, out);
+        }
+        if (workerCount > 0)
+        {
+            const TraceSpan span(suite.getTracer(), "parallel tests", "suite");
+            runTestsOnWorkers(suite, exporter, out);
+        }
+        else if (multiThreaded)
+        {
+            const TraceSpan span(suite.getTracer(), "parallel tests", "suite");
+            runTestsMultithreaded(suite, exporter, out);
+        }
+        {
+            const TraceSpan span(suite.getTracer(), "serial tests", "suite");
+            runTestsSerialized(suite, exporter, out);
+        }
+
+        // A list created during the run does not hold the results of tests that finished after it.
+        std::scoped_lock lock(dataMutex);
+        materialized = false;
     }
 
     void UnitTestSuite::resolveTests(const TestSuite& suite, std::ostream& out)
+    {
+        // Move plain TestData into the store. TestData subclasses can override create, initialize and finalize, so
+        // suites that contain any keep using the list.
+        if (!columnar && TestDataStore::canStore(data))
+        {
+            store.assign(data);
+            data.clear();
+            columnar = true;
+        }
+        materialized = false;
+
+        if (columnar)
+            resolveTestsColumnar(out);
+        else
+            resolveTestsList(suite, out);
+    }
+
+    void UnitTestSuite::resolveTestsColumnar(std::ostream& out)
+    {
+        size_t     testCount = 0;
+        const auto now       = std::chrono::system_clock::now();
+
+        for (size_t i = 0; i < runners.size(); i++)
+        {
+            // Disable tests that do not match pattern.
+            const auto& testName = runners[i]->getTestName();
+            if (!filter.match(testName, true)) continue;
+
+            // Found test, initialize. Skip non-failing tests.
+            if (const auto record = store.find(testName); record)
+            {
+                if (runFailingOnly && store.isPassing(*record)) continue;
+                store.initialize(*record, i, now);
+            }
+            // Did not find test, create new and then initialize.
+            else
+                store.initialize(store.add(testName, now), i, now);
+
+            testCount++;
+        }
+
+        out << "Running " << testCount << "/" << runners.size() << " tests\n\n";
+    }
+
+    void UnitTestSuite::resolveTestsList(const TestSuite& suite, std::ostream& out)
     {
         size_t testCount = 0;
 
@@ -124,59 +250,70 @@ namespace bt
         out << "Running " << testCount << "/" << runners.size() << " tests\n\n";
     }
 
-    void UnitTestSuite::runTestsSerialized(const TestSuite& suite, IExporter& exporter, std::ostream& out) const
+    void UnitTestSuite::runTestsSerialized(const TestSuite& suite, IExporter& exporter, std::ostream& out)
     {
-        for (const auto& testData : data)
+        const auto count = columnar ? store.size() : data.size();
+        for (size_t i = 0; i < count; i++)
         {
             // Skip tests without a runner.
-            if (!testData->hasRunnerIndex()) continue;
+            const auto runnerIndex = getRunnerIndex(i);
+            if (!runnerIndex) continue;
 
-            auto& runner = *runners[testData->runnerIndex];
+            auto& runner = *runners[*runnerIndex];
 
-            // Skip tests that can run in parallel when the suite is being run in multithreaded mode.
-            if (multiThreaded && runner.isParallel()) continue;
+            // Skip tests that can run in parallel when the suite is being run in multithreaded mode or on workers.
+            if ((multiThreaded || workerCount > 0) && runner.isParallel()) continue;
 
             // Run test.
+            const TraceSpan   span(suite.getTracer(), runner.getTestName(), "unit");
             std::stringstream ss;
-            const auto [pass, error] = runner(suite, exporter, ss);
+
+            const auto start                  = std::chrono::steady_clock::now();
+            const auto [pass, error, failure] = runTest(suite, exporter, runner, ss);
+            const auto end                    = std::chrono::steady_clock::now();
 
             // If test failed due to an exception, output error message.
             if (!pass && !error.empty()) ss << "The following error occurred:\n" << error << "\n";
 
             // Finalize test data.
-            testData->finalize(suite, pass);
+            finalizeTest(suite, i, pass, end - start, failure);
 
             // Print output.
             printResults(out, ss, pass, runner);
         }
     }
 
-    void UnitTestSuite::runTestsMultithreaded(const TestSuite& suite, IExporter& exporter, std::ostream& out) const
+    void UnitTestSuite::runTestsMultithreaded(const TestSuite& suite, IExporter& exporter, std::ostream& out)
     {
         std::vector<std::future<void>> tasks;
         std::mutex                     mutex;
 
-        for (auto& testData : data)
+        const auto count = columnar ? store.size() : data.size();
+        for (size_t i = 0; i < count; i++)
         {
             // Skip tests without a runner.
-            if (!testData->hasRunnerIndex()) continue;
+            const auto runnerIndex = getRunnerIndex(i);
+            if (!runnerIndex) continue;
 
-            auto& runner = *runners[testData->runnerIndex];
+            auto& runner = *runners[*runnerIndex];
 
             // Skip tests that cannot run in parallel.
             if (!runner.isParallel()) continue;
 
-            tasks.push_back(std::async(std::launch::async, [&] {
+            tasks.push_back(std::async(std::launch::async, [&, i] {
+                const TraceSpan   span(suite.getTracer(), runner.getTestName(), "unit");
                 std::stringstream ss;
 
                 // Run test.
-                const auto [pass, error] = runner(suite, exporter, ss);
+                const auto start                  = std::chrono::steady_clock::now();
+                const auto [pass, error, failure] = runTest(suite, exporter, runner, ss);
+                const auto end                    = std::chrono::steady_clock::now();
 
                 // If test failed due to an exception, output error message.
                 if (!pass && !error.empty()) ss << "The following error occurred:\n" << error << "\n";
 
-                // Finalize test data.
-                testData->finalize(suite, pass);
+                // Finalize test data. Each task finalizes a different test.
+                finalizeTest(suite, i, pass, end - start, failure);
 
                 // Print output.
                 {
@@ -189,4 +326,272 @@ namespace bt
         // Wait for all tests to complete.
         std::ranges::for_each(tasks.begin(), tasks.end(), [](auto& t) { t.get(); });
     }
+
+    void UnitTestSuite::runTestsOnWorkers(const TestSuite& suite, IExporter& exporter, std::ostream& out)
+    {
+        // Queue the runners of all tests that can run in parallel, and map them back to their tests.
+        std::vector<uint32_t> queue;
+        std::vector<size_t>   tests(runners.size(), static_cast<size_t>(-1));
+        const auto            count = columnar ? store.size() : data.size();
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto runnerIndex = getRunnerIndex(i);
+            if (!runnerIndex || !runners[*runnerIndex]->isParallel()) continue;
+            queue.emplace_back(static_cast<uint32_t>(*runnerIndex));
+            tests[*runnerIndex] = i;
+        }
+        if (queue.empty()) return;
+
+        // Start workers, which run this executable again and connect back. The listener is closed before waiting for
+        // the workers, so that workers that connect too late fail instead of waiting forever.
+        std::vector<int64_t>       pids;
+        std::vector<WorkerChannel> channels;
+        {
+            WorkerListener listener;
+            if (listener.listen())
+            {
+                auto arguments = workerCommand;
+                arguments.emplace_back("--worker");
+                arguments.emplace_back(listener.getSocket().string());
+                for (size_t w = 0; w < std::min(workerCount, queue.size()); w++)
+                    if (const auto pid = spawnWorker(arguments); pid) pids.emplace_back(*pid);
+            }
+
+            for (size_t w = 0; w < pids.size(); w++)
+            {
+                auto channel = listener.accept(workerConnectTimeout);
+                if (!channel) break;
+                channels.emplace_back(std::move(*channel));
+            }
+        }
+
+        if (channels.empty())
+        {
+            for (const auto pid : pids) waitWorker(pid);
+            out << "Could not start worker processes. Running tests in this process\n\n";
+            runTestsMultithreaded(suite, exporter, out);
+            return;
+        }
+
+        std::mutex queueMutex;
+        std::mutex printMutex;
+        size_t     next = 0;
+
+        const auto report = [&](const WorkerResult& result) {
+            auto&             runner = *runners[result.runner];
+            std::stringstream ss;
+            ss << result.output;
+
+            // If test failed due to an exception, output error message.
+            if (!result.pass && !result.error.empty()) ss << "The following error occurred:\n" << result.error << "\n";
+
+            // Finalize test data. Each result finalizes a different test.
+            finalizeTest(suite, tests[result.runner], result.pass, result.duration, result.failure);
+
+            // Print output.
+            std::scoped_lock lock(printMutex);
+            printResults(out, ss, result.pass, runner);
+        };
+
+        const auto failed = [](const uint32_t runner, const failure_t failure, std::string error) {
+            WorkerResult result;
+            result.runner  = runner;
+            result.failure = failure;
+            result.error   = std::move(error);
+            return result;
+        };
+
+        // A worker that sends no frame within the wall-clock time limit of the test it is running has hung.
+        const auto getTimeLimit = [&](const std::deque<uint32_t>& pending) {
+            const auto l =
+              pending.empty() ? limits : runners[pending.front()]->getResourceLimits().withDefaults(limits);
+            return l.wallSeconds ? l.wallSeconds : isolatedTimeout;
+        };
+
+        // Serve each worker from its own thread. Workers run their batch in order, so results arrive in the order the
+        // tests were sent.
+        std::vector<std::future<void>> tasks;
+        for (auto& channel : channels)
+        {
+            tasks.push_back(std::async(std::launch::async, [&] {
+                const TraceSpan       span(suite.getTracer(), "worker", "unit");
+                std::deque<uint32_t>  pending;
+                std::vector<uint32_t> batch;
+                frame_t               type = frame_t::request;
+                std::string           payload;
+                WorkerResult          result;
+                bool                  done     = false;
+                bool                  timedOut = false;
+
+                while (!done)
+                {
+                    if (!channel.wait(std::chrono::seconds(getTimeLimit(pending))))
+                    {
+                        timedOut = true;
+                        break;
+                    }
+                    if (!channel.receive(type, payload)) break;
+
+                    if (type == frame_t::result)
+                    {
+                        if (!decodeResult(payload, result) || pending.empty() || pending.front() != result.runner)
+                            break;
+                        pending.pop_front();
+                        report(result);
+                    }
+                    else if (type == frame_t::request)
+                    {
+                        {
+                            std::scoped_lock lock(queueMutex);
+                            const auto       size = getBatchSize(queue.size() - next, channels.size());
+                            batch.assign(queue.begin() + static_cast<ptrdiff_t>(next),
+                                         queue.begin() + static_cast<ptrdiff_t>(next + size));
+                            next += size;
+                        }
+
+                        pending.insert(pending.end(), batch.begin(), batch.end());
+                        done = batch.empty();
+                        if (!channel.send(frame_t::batch, encodeBatch(batch))) break;
+                    }
+                    else
+                        break;
+                }
+
+                // Terminate a worker that hung, so that it can be waited for.
+                if (timedOut)
+                    if (const auto pid = channel.getPeerProcess(); pid) killWorker(*pid);
+
+                // The worker exited, hung or sent a malformed frame. Blame the test it was running and queue the
+                // others of its batch again.
+                if (pending.empty()) return;
+                if (timedOut)
+                    report(failed(pending.front(),
+                                  failure_t::time_limit,
+                                  std::format("The test did not finish within its time limit of {} s",
+                                              getTimeLimit(pending))));
+                else
+                    report(failed(pending.front(),
+                                  failure_t::crashed,
+                                  "The worker process running the test exited unexpectedly"));
+                pending.pop_front();
+                std::scoped_lock lock(queueMutex);
+                queue.insert(queue.end(), pending.begin(), pending.end());
+            }));
+        }
+
+        // Wait for all workers to finish.
+        std::ranges::for_each(tasks.begin(), tasks.end(), [](auto& t) { t.get(); });
+        for (const auto pid : pids) waitWorker(pid);
+
+        // Tests that were queued again after all other workers had already exited run in this process.
+        if (next < queue.size()) out << "No worker process was left. Running the remaining tests in this process\n\n";
+        for (; next < queue.size(); next++)
+        {
+            auto&             runner = *runners[queue[next]];
+            const TraceSpan   span(suite.getTracer(), runner.getTestName(), "unit");
+            std::stringstream ss;
+
+            // Run test.
+            const auto start            = std::chrono::steady_clock::now();
+            auto [pass, error, failure] = runTest(suite, exporter, runner, ss);
+            const auto end              = std::chrono::steady_clock::now();
+
+            WorkerResult result;
+            result.runner   = queue[next];
+            result.pass     = pass;
+            result.failure  = failure;
+            result.duration = end - start;
+            result.error    = std::move(error);
+            result.output   = ss.str();
+            report(result);
+        }
+    }
+
+    bool UnitTestSuite::runWorker(const TestSuite& suite, IExporter& exporter, const std::filesystem::path& socket)
+    {
+        const auto channel = WorkerChannel::connect(socket);
+        if (!channel) return false;
+
+        frame_t               type = frame_t::batch;
+        std::string           payload;
+        std::vector<uint32_t> batch;
+        while (channel->send(frame_t::request) && channel->receive(type, payload))
+        {
+            if (type != frame_t::batch || !decodeBatch(payload, batch)) return false;
+
+            // An empty batch means there are no tests left.
+            if (batch.empty()) return true;
+
+            for (const auto r : batch)
+            {
+                if (r >= runners.size()) return false;
+
+                // Run test.
+                std::stringstream ss;
+                const auto        start   = std::chrono::steady_clock::now();
+                auto [pass, error, failure] = runTest(suite, exporter, *runners[r], ss);
+                const auto end              = std::chrono::steady_clock::now();
+
+                // Send result.
+                WorkerResult result;
+                result.runner   = r;
+                result.pass     = pass;
+                result.failure  = failure;
+                result.duration = end - start;
+                result.error    = std::move(error);
+                result.output   = ss.str();
+                if (!channel->send(frame_t::result, encodeResult(result))) return false;
+            }
+        }
+
+        return false;
+    }
+
+    std::tuple<bool, std::string, failure_t> UnitTestSuite::runTest(const TestSuite& suite,
+                                                                    IExporter&       exporter,
+                                                                    ITestRunner&     runner,
+                                                                    std::ostream&    out) const
+    {
+        if (!isolated)
+        {
+            auto [pass, error] = runner(suite, exporter, out);
+            return {pass, std::move(error), pass ? failure_t::none : failure_t::failed};
+        }
+
+        // The test and exporter run in the child process. Only the result is sent back.
+        auto result = runIsolated([&](std::ostream& o) { return runner(suite, exporter, o); },
+                                  runner.getResourceLimits().withDefaults(limits));
+        out << result.output;
+        return {result.pass, std::move(result.error), result.failure};
+    }
+
+    std::optional<size_t> UnitTestSuite::getRunnerIndex(const size_t test) const noexcept
+    {
+        if (columnar)
+        {
+            if (!store.hasRunnerIndex(test)) return std::nullopt;
+            return store.getRunnerIndex(test);
+        }
+
+        if (!data[test]->hasRunnerIndex()) return std::nullopt;
+        return data[test]->runnerIndex;
+    }
+
+    void UnitTestSuite::finalizeTest(const TestSuite&               suite,
+                                     const size_t                   test,
+                                     const bool                     pass,
+                                     const std::chrono::nanoseconds duration,
+                                     const failure_t                failure)
+    {
+        if (columnar)
+        {
+            std::scoped_lock lock(dataMutex);
+            store.finalize(test, pass, duration, failure);
+            return;
+        }
+
+        data[test]->duration = duration;
+        data[test]->failure  = failure;
+        data[test]->finalize(suite, pass);
+    }
 }  // namespace bt
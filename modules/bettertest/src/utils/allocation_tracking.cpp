@@ -0,0 +1,242 @@
+#include "bettertest/utils/allocation_tracking.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef BETTERTEST_REPLACE_GLOBAL_NEW
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+#endif
+
+namespace
+{
+    /**
+     * \brief Allocation counters of a single thread. Constant initialized, so that it is safe to use from operator
+     * new at any point during the lifetime of a thread.
+     */
+    struct AllocationState
+    {
+        bool     active        = false;
+        uint64_t allocations   = 0;
+        uint64_t deallocations = 0;
+        uint64_t bytes         = 0;
+        int64_t  liveBytes     = 0;
+        int64_t  peakLiveBytes = 0;
+    };
+
+    constinit thread_local AllocationState state;
+
+#ifdef BETTERTEST_REPLACE_GLOBAL_NEW
+    [[nodiscard]] size_t usableSize(void* ptr, [[maybe_unused]] const bool aligned) noexcept
+    {
+#if defined(_WIN32)
+        return aligned ? _aligned_msize(ptr, 1, 0) : _msize(ptr);
+#elif defined(__APPLE__)
+        return malloc_size(ptr);
+#else
+        return malloc_usable_size(ptr);
+#endif
+    }
+
+    void onAllocate(void* ptr, const size_t size, const bool aligned) noexcept
+    {
+        if (!state.active || !ptr) return;
+        state.allocations++;
+        state.bytes += size;
+        state.liveBytes += static_cast<int64_t>(usableSize(ptr, aligned));
+        state.peakLiveBytes = std::max(state.peakLiveBytes, state.liveBytes);
+    }
+
+    void onDeallocate(void* ptr, const bool aligned) noexcept
+    {
+        if (!state.active || !ptr) return;
+        state.deallocations++;
+        state.liveBytes -= static_cast<int64_t>(usableSize(ptr, aligned));
+    }
+
+    [[nodiscard]] void* allocate(size_t size) noexcept
+    {
+        if (size == 0) size = 1;
+        void* ptr = std::malloc(size);
+        onAllocate(ptr, size, false);
+        return ptr;
+    }
+
+    [[nodiscard]] void* allocateAligned(size_t size, const std::align_val_t alignment) noexcept
+    {
+        if (size == 0) size = 1;
+        const auto align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+#if defined(_WIN32)
+        void* ptr = _aligned_malloc(size, align);
+#else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, align, size) != 0) ptr = nullptr;
+#endif
+        onAllocate(ptr, size, true);
+        return ptr;
+    }
+
+    void deallocate(void* ptr) noexcept
+    {
+        onDeallocate(ptr, false);
+        std::free(ptr);
+    }
+
+    void deallocateAligned(void* ptr) noexcept
+    {
+        onDeallocate(ptr, true);
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    /**
+     * \brief Allocate, calling the new handler until allocation succeeds or no handler is installed.
+     */
+    template<typename F>
+    [[nodiscard]] void* allocateOrThrow(const F& f)
+    {
+        while (true)
+        {
+            if (void* ptr = f()) return ptr;
+            const auto handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    template<typename F>
+    [[nodiscard]] void* allocateOrNull(const F& f) noexcept
+    {
+        try
+        {
+            return allocateOrThrow(f);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+#endif
+}  // namespace
+
+#ifdef BETTERTEST_REPLACE_GLOBAL_NEW
+////////////////////////////////////////////////////////////////
+// Replaced global operators.
+////////////////////////////////////////////////////////////////
+
+void* operator new(const size_t size)
+{
+    return allocateOrThrow([&] { return allocate(size); });
+}
+
+void* operator new[](const size_t size)
+{
+    return allocateOrThrow([&] { return allocate(size); });
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateOrNull([&] { return allocate(size); });
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateOrNull([&] { return allocate(size); });
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+    return allocateOrThrow([&] { return allocateAligned(size, alignment); });
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment)
+{
+    return allocateOrThrow([&] { return allocateAligned(size, alignment); });
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateOrNull([&] { return allocateAligned(size, alignment); });
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateOrNull([&] { return allocateAligned(size, alignment); });
+}
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { deallocate(ptr); }
+
+void operator delete[](void* ptr, size_t) noexcept { deallocate(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocateAligned(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocateAligned(ptr); }
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { deallocateAligned(ptr); }
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { deallocateAligned(ptr); }
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(ptr); }
+#endif
+
+namespace bt
+{
+    bool isAllocationTrackingAvailable() noexcept
+    {
+#ifdef BETTERTEST_REPLACE_GLOBAL_NEW
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    AllocationScope::AllocationScope() noexcept :
+        wasActive(state.active),
+        allocations(state.allocations),
+        deallocations(state.deallocations),
+        bytes(state.bytes),
+        liveBytes(state.liveBytes),
+        peakLiveBytes(state.peakLiveBytes)
+    {
+        // Measure the peak of this scope separately. The outer peak is restored on destruction.
+        state.active        = true;
+        state.peakLiveBytes = state.liveBytes;
+    }
+
+    AllocationScope::~AllocationScope() noexcept
+    {
+        state.active        = wasActive;
+        state.peakLiveBytes = std::max(state.peakLiveBytes, peakLiveBytes);
+    }
+
+    AllocationStats AllocationScope::getStats() const noexcept
+    {
+        return {static_cast<size_t>(state.allocations - allocations),
+                static_cast<size_t>(state.deallocations - deallocations),
+                static_cast<size_t>(state.bytes - bytes),
+                static_cast<size_t>(std::max<int64_t>(0, state.peakLiveBytes - liveBytes))};
+    }
+}  // namespace bt
@@ -0,0 +1,516 @@
+#include "bettertest/utils/benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <cmath>
+#include <exception>
+#include <format>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <thread>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/environment.h"
+
+namespace
+{
+    thread_local size_t threadIndex = 0;
+
+    /**
+     * \brief Times of a batch run by one or more threads.
+     */
+    struct BatchTimes
+    {
+        /**
+         * \brief Time of the slowest thread.
+         */
+        std::chrono::nanoseconds slowest{0};
+
+        /**
+         * \brief Sum of the times of all threads.
+         */
+        std::chrono::nanoseconds total{0};
+    };
+
+    /**
+     * \brief Highest latency that is recorded in latency histograms. Longer iterations are clamped to this value.
+     */
+    constexpr uint64_t maxTrackableLatency = 10'000'000'000;
+
+    /**
+     * \brief Team of threads that run jobs together. The threads are started once and reused for every batch, so that
+     * starting threads is neither measured nor repeated for each batch. A team of one thread runs jobs on the calling
+     * thread.
+     */
+    class ThreadTeam
+    {
+    public:
+        explicit ThreadTeam(const size_t threads) :
+            errors(threads),
+            start(static_cast<std::ptrdiff_t>(threads + 1)),
+            done(static_cast<std::ptrdiff_t>(threads + 1))
+        {
+            if (threads <= 1) return;
+            workers.reserve(threads);
+            for (size_t i = 0; i < threads; i++) workers.emplace_back([this, i] { work(i); });
+        }
+
+        ThreadTeam(const ThreadTeam&) = delete;
+
+        ThreadTeam(ThreadTeam&&) = delete;
+
+        ~ThreadTeam() noexcept
+        {
+            if (workers.empty()) return;
+            stopping = true;
+            start.arrive_and_wait();
+        }
+
+        ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+        ThreadTeam& operator=(ThreadTeam&&) = delete;
+
+        [[nodiscard]] size_t size() const noexcept { return errors.size(); }
+
+        /**
+         * \brief Run a job on each thread and wait for all of them to finish. Rethrows the first exception of any
+         * thread.
+         * \param f Callable taking the thread index.
+         */
+        void operator()(std::function<void(size_t)> f)
+        {
+            if (workers.empty())
+            {
+                f(size_t{0});
+                return;
+            }
+
+            job = std::move(f);
+            start.arrive_and_wait();
+            done.arrive_and_wait();
+
+            std::exception_ptr error;
+            for (auto& e : errors)
+            {
+                if (!error) error = e;
+                e = nullptr;
+            }
+            if (error) std::rethrow_exception(error);
+        }
+
+    private:
+        void work(const size_t i)
+        {
+            // Workers inherit the pinning of the calling thread, but should be spread over all CPUs.
+            bt::unpinThread();
+            threadIndex = i;
+
+            while (true)
+            {
+                // Release all threads at once, so that they contend with each other for the entire job.
+                start.arrive_and_wait();
+                if (stopping) return;
+                try
+                {
+                    job(i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+                done.arrive_and_wait();
+            }
+        }
+
+        std::vector<std::exception_ptr> errors;
+
+        /**
+         * \brief Barriers shared by the workers and the calling thread, which waits for the workers to start and
+         * finish each job.
+         */
+        std::barrier<> start;
+        std::barrier<> done;
+
+        std::function<void(size_t)> job;
+
+        /**
+         * \brief Set before the final release of the start barrier, which makes it visible to the workers.
+         */
+        bool stopping = false;
+
+        /**
+         * \brief Declared last, so that the threads are joined before the other members are destroyed.
+         */
+        std::vector<std::jthread> workers;
+    };
+
+    [[nodiscard]] BatchTimes runThreads(ThreadTeam& team, const bt::batch_function_t& batch, const uint64_t iterations)
+    {
+        std::vector<std::chrono::nanoseconds> times(team.size());
+        team([&](const size_t i) { times[i] = batch(iterations); });
+        return {std::ranges::max(times), std::accumulate(times.begin(), times.end(), std::chrono::nanoseconds{0})};
+    }
+
+    [[nodiscard]] double median(std::vector<double>& values)
+    {
+        const auto mid = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::ranges::nth_element(values, mid);
+        if (values.size() % 2 == 1) return *mid;
+
+        // Even number of values, average the two middle elements.
+        const auto lower = *std::max_element(values.begin(), mid);
+        return (lower + *mid) / 2;
+    }
+
+    /**
+     * \brief Multiple of BenchmarkOptions::minTime and warmupTime that calibrating and warming up may take in
+     * wall-clock time. Measured time excludes paused sections, so a test with expensive untimed setup and a cheap
+     * timed body would otherwise grow its batches toward maxIterations.
+     */
+    constexpr int64_t wallTimeFactor = 5;
+
+    [[nodiscard]] uint64_t nextIterationCount(const uint64_t                 iterations,
+                                              const std::chrono::nanoseconds elapsed,
+                                              const std::chrono::nanoseconds wall,
+                                              const bt::BenchmarkOptions&    options)
+    {
+        // Far below the target time, the measurement is too noisy to extrapolate from. Grow geometrically.
+        uint64_t next = iterations * 10;
+
+        // Otherwise, extrapolate with a small margin so that the next batch reaches the target time.
+        if (elapsed > options.minTime / 10)
+        {
+            const auto ratio = static_cast<double>(options.minTime.count()) / static_cast<double>(elapsed.count());
+            next             = static_cast<uint64_t>(std::ceil(static_cast<double>(iterations) * ratio * 1.1));
+        }
+
+        // Do not let the next batch exceed its wall-clock budget.
+        if (wall.count() > 0)
+        {
+            const auto budget = static_cast<double>((options.minTime * wallTimeFactor).count());
+            const auto limit  = std::ceil(static_cast<double>(iterations) * budget / static_cast<double>(wall.count()));
+            next              = std::min(next, static_cast<uint64_t>(limit));
+        }
+
+        // Only called while iterations < maxIterations.
+        return std::clamp(next, iterations + 1, options.maxIterations);
+    }
+
+    [[nodiscard]] std::string formatTime(const double ns)
+    {
+        if (ns < 1e3) return std::format("{:.2f}ns", ns);
+        if (ns < 1e6) return std::format("{:.2f}us", ns / 1e3);
+        if (ns < 1e9) return std::format("{:.2f}ms", ns / 1e6);
+        return std::format("{:.2f}s", ns / 1e9);
+    }
+
+    /**
+     * \brief Format a rate per second with a decimal prefix, in bytes for the bytes counter.
+     */
+    [[nodiscard]] std::string formatRate(const bt::CounterResults& counter)
+    {
+        constexpr std::array<std::string_view, 5> prefixes = {"", "k", "M", "G", "T"};
+
+        auto   rate   = counter.rate;
+        size_t prefix = 0;
+        while (rate >= 1000 && prefix + 1 < prefixes.size())
+        {
+            rate /= 1000;
+            prefix++;
+        }
+
+        if (counter.name == "bytes") return std::format("{:.2f} {}B/s", rate, prefixes[prefix]);
+        return std::format("{} {:.2f}{}/s", counter.name, rate, prefixes[prefix]);
+    }
+
+    /**
+     * \brief Coefficient of variation above which results are reported as noisy.
+     */
+    constexpr double maxCoefficientOfVariation = 0.05;
+}  // namespace
+
+namespace bt
+{
+    std::vector<int64_t> ArgumentRange::expand() const
+    {
+        // Guard against ranges that would never terminate.
+        const auto linear = type == type_t::linear;
+        if ((linear ? step <= 0 : step <= 1 || first <= 0) || first >= last) return {first};
+
+        std::vector<int64_t> arguments;
+        for (auto value = first;;)
+        {
+            arguments.push_back(value);
+
+            // Check against last before stepping, so that value cannot overflow.
+            if (linear ? value > last - step : value > last / step) break;
+            value = linear ? value + step : value * step;
+        }
+
+        if (arguments.back() != last) arguments.push_back(last);
+
+        return arguments;
+    }
+
+    BenchmarkStatistics computeStatistics(const std::span<const double> samples)
+    {
+        BenchmarkStatistics stats;
+        if (samples.empty()) return stats;
+
+        const auto n = static_cast<double>(samples.size());
+        stats.min    = std::ranges::min(samples);
+        stats.mean   = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+
+        if (samples.size() > 1)
+        {
+            double squares = 0;
+            for (const auto x : samples) squares += (x - stats.mean) * (x - stats.mean);
+            stats.stddev = std::sqrt(squares / (n - 1));
+            if (stats.mean > 0) stats.cv = stats.stddev / stats.mean;
+        }
+
+        std::vector<double> values(samples.begin(), samples.end());
+        stats.median = median(values);
+
+        for (auto& v : values) v = std::abs(v - stats.median);
+        stats.mad = median(values);
+
+        return stats;
+    }
+
+    uint64_t getPauseOverhead()
+    {
+        static const uint64_t overhead = [] {
+            // Measure the part of a pause that is still counted. Take the minimum of several rounds, as anything else
+            // is interference.
+            const auto& timer  = Timer::get();
+            auto        result = UINT64_MAX;
+            for (size_t round = 0; round < 100; round++)
+            {
+                constexpr uint64_t pairs = 100;
+                resetPausedTime();
+                const auto start = timer.now();
+                for (uint64_t i = 0; i < pairs; i++)
+                {
+                    pauseTiming();
+                    resumeTiming();
+                }
+                const auto end     = timer.now();
+                const auto counted = end - start - std::min(internal::pausedTime.ticks, end - start);
+                result             = std::min(result, counted / pairs);
+            }
+            resetPausedTime();
+            return result;
+        }();
+
+        return overhead;
+    }
+
+    std::chrono::nanoseconds getUnpausedTime(const uint64_t start, const uint64_t end)
+    {
+        const auto excluded = internal::pausedTime.ticks + internal::pausedTime.pauses * getPauseOverhead();
+        return Timer::get().elapsed(start, end - std::min(excluded, end - start));
+    }
+
+    size_t getBenchmarkThreadIndex() noexcept { return threadIndex; }
+
+    int64_t resolveThreadCount(const int64_t count) noexcept
+    {
+        if (count == hardwareThreads) return std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+        return std::max<int64_t>(count, 1);
+    }
+
+    BenchmarkResults runBenchmark(const batch_function_t& batch, const BenchmarkOptions& options, const size_t threads)
+    {
+        BenchmarkResults results;
+        results.threads    = std::max<size_t>(threads, 1);
+        results.iterations = 1;
+
+        // Start the threads once for all batches.
+        ThreadTeam team(results.threads);
+
+        // Warm up caches, branch predictors and CPU frequency while calibrating the number of iterations. Stop once
+        // both the warm-up time has passed and a single batch reaches the target time. Both are also bounded by wall
+        // time, which includes paused sections and compensated overhead.
+        std::chrono::nanoseconds warmup{0};
+        std::chrono::nanoseconds warmupWall{0};
+        while (true)
+        {
+            const auto start   = std::chrono::steady_clock::now();
+            const auto elapsed = runThreads(team, batch, results.iterations).slowest;
+            const auto wall    = std::chrono::nanoseconds(std::chrono::steady_clock::now() - start);
+            warmup += elapsed;
+            warmupWall += wall;
+
+            const auto calibrated = elapsed >= options.minTime || results.iterations >= options.maxIterations ||
+                                    wall >= options.minTime * wallTimeFactor;
+            const auto warm = warmup >= options.warmupTime || warmupWall >= options.warmupTime * wallTimeFactor;
+            if (calibrated && warm) break;
+            if (!calibrated) results.iterations = nextIterationCount(results.iterations, elapsed, wall, options);
+        }
+
+        // Measure.
+        const auto               iterations = static_cast<double>(results.iterations);
+        std::chrono::nanoseconds total{0};
+        results.samples.reserve(options.repetitions);
+        for (size_t i = 0; i < options.repetitions; i++)
+        {
+            const auto times = runThreads(team, batch, results.iterations);
+            results.samples.push_back(static_cast<double>(times.slowest.count()) / iterations);
+            total += times.total;
+        }
+
+        results.statistics = computeStatistics(results.samples);
+        if (results.statistics.median > 0)
+            results.throughput = static_cast<double>(results.threads) * 1e9 / results.statistics.median;
+        if (!results.samples.empty())
+            results.latency = static_cast<double>(total.count()) /
+                              (iterations * static_cast<double>(results.samples.size() * results.threads));
+
+        return results;
+    }
+
+    LatencyDistribution measureLatencyDistribution(const sample_function_t& sample,
+                                                   const BenchmarkOptions&  options,
+                                                   const BenchmarkResults&  results)
+    {
+        const auto threads    = std::max<size_t>(results.threads, 1);
+        const auto iterations = std::min(results.iterations, options.latencySamples);
+
+        // Each thread records into its own histogram, which are merged afterwards.
+        std::vector histograms(threads, Histogram(maxTrackableLatency, options.latencyDigits));
+        ThreadTeam team(threads);
+        team([&](const size_t i) { sample(iterations, histograms[i]); });
+        for (size_t i = 1; i < threads; i++) histograms.front().merge(histograms[i]);
+
+        const auto&         h = histograms.front();
+        LatencyDistribution distribution;
+        distribution.count     = h.getTotalCount();
+        distribution.p50       = static_cast<double>(h.getValueAtPercentile(50));
+        distribution.p90       = static_cast<double>(h.getValueAtPercentile(90));
+        distribution.p99       = static_cast<double>(h.getValueAtPercentile(99));
+        distribution.p999      = static_cast<double>(h.getValueAtPercentile(99.9));
+        distribution.p9999     = static_cast<double>(h.getValueAtPercentile(99.99));
+        distribution.max       = static_cast<double>(h.getMax());
+        distribution.histogram = h.encode();
+
+        return distribution;
+    }
+
+    BenchmarkOptions getCacheModeOptions(const BenchmarkOptions& options, const cache_mode_t cache) noexcept
+    {
+        if (cache != cache_mode_t::cold) return options;
+
+        auto cold          = options;
+        cold.warmupTime    = std::chrono::nanoseconds{0};
+        cold.maxIterations = std::max<uint64_t>(std::min(options.maxIterations, options.coldIterations), 1);
+        return cold;
+    }
+
+    void printCacheComparison(std::ostream& out, const BenchmarkResults& warm, const BenchmarkResults& cold)
+    {
+        const auto ratio = warm.statistics.median > 0 ? cold.statistics.median / warm.statistics.median : 0.0;
+        out << std::format("  Warm {} | cold {} | cold is {:.2f}x slower\n",
+                           formatTime(warm.statistics.median),
+                           formatTime(cold.statistics.median),
+                           ratio);
+    }
+
+    std::vector<CounterResults> computeCounterRates(const std::span<const Counter> counters,
+                                                    const BenchmarkResults&       results)
+    {
+        std::vector<CounterResults> rates;
+        for (const auto& counter : counters)
+        {
+            auto& c        = rates.emplace_back();
+            c.name         = counter.name;
+            c.perIteration = counter.perIteration;
+
+            // Samples are times per iteration of a single thread, while all threads process the counter.
+            const auto perSample = counter.perIteration * static_cast<double>(results.threads) * 1e9;
+            for (const auto sample : results.samples) c.rates.push_back(sample > 0 ? perSample / sample : 0);
+            if (results.statistics.median > 0) c.rate = perSample / results.statistics.median;
+        }
+
+        return rates;
+    }
+
+    const CounterResults* findCounter(const BenchmarkResults& results, const std::string_view name) noexcept
+    {
+        const auto it = std::ranges::find(results.counters, name, &CounterResults::name);
+        return it == results.counters.end() ? nullptr : &*it;
+    }
+
+    double computeEfficiency(const BenchmarkResults& results, const BenchmarkResults& reference) noexcept
+    {
+        if (reference.throughput <= 0) return 0;
+        const auto perThread          = results.throughput / static_cast<double>(results.threads);
+        const auto referencePerThread = reference.throughput / static_cast<double>(reference.threads);
+        return perThread / referencePerThread;
+    }
+
+    ComplexityFit fitBenchmarkComplexity(const std::span<const BenchmarkResults> results)
+    {
+        std::vector<int64_t> arguments;
+        std::vector<double>  times;
+        for (const auto& r : results)
+        {
+            arguments.push_back(r.argument);
+            times.push_back(r.statistics.median);
+        }
+
+        return fitComplexity(arguments, times);
+    }
+
+    void printComplexityFit(std::ostream& out, const ComplexityFit& fit, const std::optional<complexity_t> expected)
+    {
+        out << std::format("  Complexity {} (rms {:.1f}%)\n", toString(fit.complexity), fit.rms * 100);
+        if (expected && fit.complexity > *expected)
+            out << std::format("  Complexity is worse than the expected {}\n", toString(*expected));
+    }
+
+    void printBenchmarkResults(std::ostream& out, const BenchmarkResults& results)
+    {
+        const auto& stats = results.statistics;
+        out << std::format("    {} repetitions of {} iterations\n", results.samples.size(), results.iterations);
+        out << std::format("    min {} | median {} | mean {} | stddev {} | mad {} | cv {:.1f}%\n",
+                           formatTime(stats.min),
+                           formatTime(stats.median),
+                           formatTime(stats.mean),
+                           formatTime(stats.stddev),
+                           formatTime(stats.mad),
+                           stats.cv * 100);
+        if (!results.counters.empty())
+        {
+            out << "    ";
+            for (size_t i = 0; i < results.counters.size(); i++)
+                out << (i > 0 ? " | " : "") << formatRate(results.counters[i]);
+            out << "\n";
+        }
+        if (results.efficiency)
+            out << std::format("    throughput {:.0f}/s | latency {} | efficiency {:.1f}%\n",
+                               results.throughput,
+                               formatTime(results.latency),
+                               *results.efficiency * 100);
+        if (const auto& d = results.distribution)
+            out << std::format("    p50 {} | p90 {} | p99 {} | p99.9 {} | p99.99 {} | max {}\n",
+                               formatTime(d->p50),
+                               formatTime(d->p90),
+                               formatTime(d->p99),
+                               formatTime(d->p999),
+                               formatTime(d->p9999),
+                               formatTime(d->max));
+        if (stats.cv > maxCoefficientOfVariation) out << "    Warning: high variation between repetitions\n";
+        if (results.throttled) out << "    Warning: CPU was thermally throttled while measuring\n";
+    }
+}  // namespace bt
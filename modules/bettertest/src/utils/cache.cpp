@@ -0,0 +1,120 @@
+#include "bettertest/utils/cache.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <string>
+
+#if defined __x86_64__ || defined _M_X64
+#if defined _MSC_VER && !defined __clang__
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "bettertest/utils/optimizer_barrier.h"
+
+namespace
+{
+    /**
+     * \brief Cache line size assumed when streaming and flushing. Smaller than or equal to the actual size on all
+     * common platforms, so no line is skipped.
+     */
+    constexpr size_t cacheLineSize = 64;
+
+    /**
+     * \brief Cache size assumed if it cannot be determined.
+     */
+    constexpr size_t defaultCacheSize = 32 * 1024 * 1024;
+
+    /**
+     * \brief Parse a cache size as reported by sysfs, e.g. "32768K".
+     */
+    [[nodiscard]] size_t parseCacheSize(const std::string& value)
+    {
+        size_t pos  = 0;
+        size_t size = 0;
+        try
+        {
+            size = std::stoull(value, &pos);
+        }
+        catch (...)
+        {
+            return 0;
+        }
+
+        if (pos < value.size() && value[pos] == 'K') return size * 1024;
+        if (pos < value.size() && value[pos] == 'M') return size * 1024 * 1024;
+        return size;
+    }
+}  // namespace
+
+namespace bt
+{
+    size_t getLastLevelCacheSize() noexcept
+    {
+        static const size_t cacheSize = [] {
+            size_t largest = 0;
+#ifdef __linux__
+            // Each index directory describes one cache of the first CPU, from the L1 caches up to the last level.
+            // Formatting the path and reading the file can throw, in which case the default is used.
+            try
+            {
+                for (size_t i = 0; i < 16; i++)
+                {
+                    std::ifstream file(std::format("/sys/devices/system/cpu/cpu0/cache/index{}/size", i));
+                    if (std::string line; file && std::getline(file, line))
+                        largest = std::max(largest, parseCacheSize(line));
+                }
+            }
+            catch (...)
+            {
+                largest = 0;
+            }
+#endif
+            return largest > 0 ? largest : defaultCacheSize;
+        }();
+
+        return cacheSize;
+    }
+
+    CacheEvictor::CacheEvictor() :
+        size(2 * getLastLevelCacheSize()), buffer(std::make_unique_for_overwrite<std::byte[]>(size))
+    {
+        // Touch all pages, so that evicting does not measure page faults.
+        std::fill_n(buffer.get(), size, std::byte{1});
+    }
+
+    void CacheEvictor::evict() const noexcept
+    {
+        // Reading is enough to replace all lines, and unlike writing it is safe to do from multiple threads.
+        std::byte sum{0};
+        for (size_t i = 0; i < size; i += cacheLineSize) sum ^= buffer[i];
+        doNotOptimize(sum);
+    }
+
+    void CacheEvictor::flush(const void* data, const size_t bytes) noexcept
+    {
+        const auto begin = reinterpret_cast<uintptr_t>(data) & ~(cacheLineSize - 1);
+        const auto end   = reinterpret_cast<uintptr_t>(data) + bytes;
+#if defined __x86_64__ || defined _M_X64
+        for (auto p = begin; p < end; p += cacheLineSize) _mm_clflush(reinterpret_cast<const void*>(p));
+        _mm_mfence();
+#elif defined __aarch64__ && (defined __GNUC__ || defined __clang__)
+        for (auto p = begin; p < end; p += cacheLineSize) asm volatile("dc civac, %0" : : "r"(p) : "memory");
+        asm volatile("dsb ish" : : : "memory");
+#else
+        static_cast<void>(begin);
+        static_cast<void>(end);
+#endif
+    }
+}  // namespace bt
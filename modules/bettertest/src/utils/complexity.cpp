@@ -0,0 +1,89 @@
+#include "bettertest/utils/complexity.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+    [[nodiscard]] double evaluate(const bt::complexity_t complexity, const double n) noexcept
+    {
+        switch (complexity)
+        {
+        case bt::complexity_t::constant: return 1;
+        case bt::complexity_t::logarithmic: return std::log2(n);
+        case bt::complexity_t::linear: return n;
+        case bt::complexity_t::linearithmic: return n * std::log2(n);
+        case bt::complexity_t::quadratic: return n * n;
+        default: return 1;
+        }
+    }
+
+    constexpr std::array complexities = {bt::complexity_t::constant,
+                                         bt::complexity_t::logarithmic,
+                                         bt::complexity_t::linear,
+                                         bt::complexity_t::linearithmic,
+                                         bt::complexity_t::quadratic};
+}  // namespace
+
+namespace bt
+{
+    std::string_view toString(const complexity_t complexity) noexcept
+    {
+        switch (complexity)
+        {
+        case complexity_t::constant: return "O(1)";
+        case complexity_t::logarithmic: return "O(log n)";
+        case complexity_t::linear: return "O(n)";
+        case complexity_t::linearithmic: return "O(n log n)";
+        case complexity_t::quadratic: return "O(n^2)";
+        default: return "O(?)";
+        }
+    }
+
+    ComplexityFit fitComplexity(const std::span<const int64_t> arguments, const std::span<const double> times)
+    {
+        ComplexityFit best;
+        const auto    count = std::min(arguments.size(), times.size());
+        if (count == 0) return best;
+
+        const auto mean = std::accumulate(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(count), 0.0) /
+                          static_cast<double>(count);
+        best.rms = std::numeric_limits<double>::infinity();
+
+        for (const auto complexity : complexities)
+        {
+            // Least squares solution of time = coefficient * f(n).
+            double ft = 0;
+            double ff = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                const auto f = evaluate(complexity, static_cast<double>(std::max<int64_t>(arguments[i], 1)));
+                ft += f * times[i];
+                ff += f * f;
+            }
+            if (ff == 0) continue;
+            const auto coefficient = ft / ff;
+
+            double squares = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                const auto f        = evaluate(complexity, static_cast<double>(std::max<int64_t>(arguments[i], 1)));
+                const auto residual = times[i] - coefficient * f;
+                squares += residual * residual;
+            }
+            const auto rms = std::sqrt(squares / static_cast<double>(count)) / (mean > 0 ? mean : 1);
+
+            // Classes are visited in order of growth, so ties go to the slowest growing class.
+            if (rms < best.rms) best = {complexity, coefficient, rms};
+        }
+
+        return best;
+    }
+}  // namespace bt
@@ -4,7 +4,6 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
-#include <chrono>
 #include <sstream>
 
 ////////////////////////////////////////////////////////////////
@@ -17,15 +16,25 @@ using namespace date;
 
 namespace bt
 {
-    std::string dateTimeAsString()
+    std::string dateTimeAsString() { return dateTimeAsString(std::chrono::system_clock::now()); }
+
+    std::string dateTimeAsString(const date_time_t time)
     {
-        const auto now   = std::chrono::system_clock::now();
-        const auto today = date::floor<days>(now);
+        const auto today = date::floor<days>(time);
 
         std::stringstream ss;
 
-        date::operator<<(ss, today) << ' ' << make_time(now - today) << " UTC";
+        date::operator<<(ss, today) << ' ' << make_time(time - today) << " UTC";
 
         return ss.str();
     }
+
+    std::optional<date_time_t> parseDateTime(const std::string& str)
+    {
+        std::istringstream ss(str);
+        date_time_t        time;
+        ss >> date::parse("%F %T", time);
+        if (ss.fail()) return std::nullopt;
+        return time;
+    }
 }  // namespace bt
\ No newline at end of file
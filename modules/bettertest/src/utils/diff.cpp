@@ -0,0 +1,542 @@
+#include "bettertest/utils/diff.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BETTERTEST_DIFF_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////
+    // Scanning.
+    ////////////////////////////////////////////////////////////////
+
+#ifdef BETTERTEST_DIFF_SSE2
+    [[nodiscard]] uint32_t equalMask(const std::byte* a, const std::byte* b) noexcept
+    {
+        const auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        const auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+    }
+#endif
+
+    [[nodiscard]] uint64_t loadWord(const std::byte* p) noexcept
+    {
+        uint64_t w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Myers.
+    ////////////////////////////////////////////////////////////////
+
+    enum class Op : uint8_t
+    {
+        Equal,
+        Delete,
+        Insert
+    };
+
+    struct Edit
+    {
+        Op       op;
+        uint32_t a;
+        uint32_t b;
+    };
+
+    /**
+     * \brief Linear space variant of Myers' O(ND) difference algorithm. Recursively splits the problem on the middle
+     * snake of the shortest edit script, so that only two diagonal vectors of size O(N + M) are needed.
+     */
+    class MyersDiff
+    {
+    public:
+        MyersDiff(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs) :
+            a(lhs),
+            b(rhs),
+            deleted(lhs.size(), false),
+            inserted(rhs.size(), false),
+            forward(2 * std::min(lhs.size(), rhs.size()) + 2),
+            backward(forward.size())
+        {
+        }
+
+        [[nodiscard]] std::vector<Edit> operator()()
+        {
+            compare(0, a.size(), 0, b.size());
+
+            // Walk both sequences to create the edit script.
+            std::vector<Edit> edits;
+            edits.reserve(a.size() + b.size());
+            size_t i = 0, j = 0;
+            while (i < a.size() || j < b.size())
+            {
+                if (i < a.size() && deleted[i])
+                    edits.emplace_back(Op::Delete, static_cast<uint32_t>(i++), static_cast<uint32_t>(j));
+                else if (j < b.size() && inserted[j])
+                    edits.emplace_back(Op::Insert, static_cast<uint32_t>(i), static_cast<uint32_t>(j++));
+                else
+                    edits.emplace_back(Op::Equal, static_cast<uint32_t>(i++), static_cast<uint32_t>(j++));
+            }
+
+            return edits;
+        }
+
+    private:
+        struct Snake
+        {
+            size_t x;
+            size_t y;
+            size_t u;
+            size_t v;
+        };
+
+        void compare(size_t a0, size_t a1, size_t b0, size_t b1)
+        {
+            // Strip common prefix and suffix.
+            while (a0 < a1 && b0 < b1 && a[a0] == b[b0]) a0++, b0++;
+            while (a0 < a1 && b0 < b1 && a[a1 - 1] == b[b1 - 1]) a1--, b1--;
+
+            if (a0 == a1)
+            {
+                std::fill(inserted.begin() + b0, inserted.begin() + b1, true);
+                return;
+            }
+
+            if (b0 == b1)
+            {
+                std::fill(deleted.begin() + a0, deleted.begin() + a1, true);
+                return;
+            }
+
+            // After stripping, the shortest edit script has at least 2 edits and both halves are strictly smaller.
+            const auto s = middleSnake(a0, a1, b0, b1);
+            compare(a0, s.x, b0, s.y);
+            compare(s.u, a1, s.v, b1);
+        }
+
+        [[nodiscard]] Snake middleSnake(const size_t a0, const size_t a1, const size_t b0, const size_t b1)
+        {
+            const auto n     = static_cast<ptrdiff_t>(a1 - a0);
+            const auto m     = static_cast<ptrdiff_t>(b1 - b0);
+            const auto l     = n + m;
+            const auto z     = 2 * std::min(n, m) + 2;
+            const auto delta = n - m;
+            const auto wrap  = [z](const ptrdiff_t k) { return static_cast<size_t>(((k % z) + z) % z); };
+
+            std::fill_n(forward.begin(), z, 0);
+            std::fill_n(backward.begin(), z, 0);
+
+            for (ptrdiff_t h = 0; h <= l / 2 + l % 2; h++)
+            {
+                for (int r = 0; r < 2; r++)
+                {
+                    // Forward pass compares from the start, backward pass from the end of both sequences.
+                    const bool fwd   = r == 0;
+                    auto&      c     = fwd ? forward : backward;
+                    const auto& d    = fwd ? backward : forward;
+                    const auto  at   = [&](const ptrdiff_t x, const ptrdiff_t y) {
+                        return fwd ? a[a0 + x] == b[b0 + y] : a[a1 - 1 - x] == b[b1 - 1 - y];
+                    };
+
+                    const auto kmin = -(h - 2 * std::max<ptrdiff_t>(0, h - m));
+                    const auto kmax = h - 2 * std::max<ptrdiff_t>(0, h - n);
+                    for (auto k = kmin; k <= kmax; k += 2)
+                    {
+                        auto x = k == -h || (k != h && c[wrap(k - 1)] < c[wrap(k + 1)]) ? c[wrap(k + 1)] :
+                                                                                         c[wrap(k - 1)] + 1;
+                        auto y = x - k;
+
+                        const auto xs = x;
+                        const auto ys = y;
+                        while (x < n && y < m && at(x, y)) x++, y++;
+                        c[wrap(k)] = x;
+
+                        const auto o  = fwd ? 1 : 0;
+                        const auto zk = delta - k;
+                        if (l % 2 == o && zk >= -(h - o) && zk <= h - o && c[wrap(k)] + d[wrap(zk)] >= n)
+                        {
+                            if (fwd) return toSnake(a0, b0, xs, ys, x, y);
+                            return toSnake(a0, b0, n - x, m - y, n - xs, m - ys);
+                        }
+                    }
+                }
+            }
+
+            // Unreachable: the forward and backward paths always overlap.
+            return {a0, b0, a1, b1};
+        }
+
+        [[nodiscard]] static Snake toSnake(const size_t a0,
+                                           const size_t b0,
+                                           const ptrdiff_t x,
+                                           const ptrdiff_t y,
+                                           const ptrdiff_t u,
+                                           const ptrdiff_t v) noexcept
+        {
+            return {a0 + static_cast<size_t>(x),
+                    b0 + static_cast<size_t>(y),
+                    a0 + static_cast<size_t>(u),
+                    b0 + static_cast<size_t>(v)};
+        }
+
+        const std::vector<uint32_t>& a;
+        const std::vector<uint32_t>& b;
+        std::vector<bool>            deleted;
+        std::vector<bool>            inserted;
+        std::vector<ptrdiff_t>       forward;
+        std::vector<ptrdiff_t>       backward;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    // Formatting.
+    ////////////////////////////////////////////////////////////////
+
+    /**
+     * \brief Writes a run of edits of the same type, up to the given number of lines. Returns the number of edits that
+     * were written and the number of lines used.
+     */
+    using run_writer_t = std::function<std::pair<size_t, size_t>(std::string&, Op, const Edit*, const Edit*, size_t)>;
+
+    /**
+     * \brief Write the edit script as unified diff hunks. Returns false if output was truncated.
+     */
+    bool writeHunks(std::string&             out,
+                    const std::vector<Edit>& edits,
+                    const size_t             lineA,
+                    const size_t             lineB,
+                    const size_t             context,
+                    const size_t             maxLines,
+                    const run_writer_t&      writeRun)
+    {
+        size_t lines = 0;
+        size_t i     = 0;
+        while (i < edits.size())
+        {
+            // Find next change.
+            while (i < edits.size() && edits[i].op == Op::Equal) i++;
+            if (i == edits.size()) break;
+
+            // Extend hunk until there is a gap of more than 2 * context unchanged edits.
+            const size_t start = i > context ? i - context : 0;
+            size_t       end   = i;
+            while (end < edits.size())
+            {
+                size_t gap = end;
+                while (gap < edits.size() && edits[gap].op == Op::Equal) gap++;
+                if (gap == edits.size() || gap - end > 2 * context)
+                {
+                    end = std::min(edits.size(), end + context);
+                    break;
+                }
+                while (gap < edits.size() && edits[gap].op != Op::Equal) gap++;
+                end = gap;
+            }
+
+            // Header.
+            size_t countA = 0, countB = 0;
+            for (size_t j = start; j < end; j++)
+            {
+                countA += edits[j].op != Op::Insert ? 1 : 0;
+                countB += edits[j].op != Op::Delete ? 1 : 0;
+            }
+            out += std::format(
+              "\n@@ -{0},{1} +{2},{3} @@", lineA + edits[start].a, countA, lineB + edits[start].b, countB);
+
+            // Runs of equal operations.
+            for (size_t j = start; j < end;)
+            {
+                size_t k = j;
+                while (k < end && edits[k].op == edits[j].op) k++;
+                const auto [written, used] =
+                  writeRun(out, edits[j].op, edits.data() + j, edits.data() + k, maxLines - lines);
+                j += written;
+                lines += used;
+                if (lines >= maxLines) return j == edits.size();
+            }
+
+            i = end;
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] char prefix(const Op op) noexcept
+    {
+        switch (op)
+        {
+        case Op::Delete: return '-';
+        case Op::Insert: return '+';
+        default: return ' ';
+        }
+    }
+
+    [[nodiscard]] std::string escape(const std::string_view s)
+    {
+        std::string res;
+        res.reserve(s.size());
+        for (const auto c : s)
+        {
+            if (c == '\n')
+                res += "\\n";
+            else if (c == '\r')
+                res += "\\r";
+            else if (c == '\t')
+                res += "\\t";
+            else
+                res += c;
+        }
+        return res;
+    }
+
+    /**
+     * \brief Split text into lines, excluding the line terminators. Stops after limit lines.
+     */
+    [[nodiscard]] std::vector<std::string_view>
+      splitLines(const std::string_view text, const size_t limit, bool& truncated)
+    {
+        std::vector<std::string_view> lines;
+        size_t                        pos = 0;
+        while (pos < text.size())
+        {
+            if (lines.size() == limit)
+            {
+                truncated = true;
+                break;
+            }
+
+            const auto nl = text.find('\n', pos);
+            if (nl == std::string_view::npos)
+            {
+                lines.emplace_back(text.substr(pos));
+                break;
+            }
+            lines.emplace_back(text.substr(pos, nl - pos));
+            pos = nl + 1;
+        }
+        return lines;
+    }
+
+    [[nodiscard]] std::span<const std::byte> asBytes(const std::string_view s) noexcept
+    {
+        return std::as_bytes(std::span(s.data(), s.size()));
+    }
+}  // namespace
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // Scanning.
+    ////////////////////////////////////////////////////////////////
+
+    size_t findFirstMismatch(const std::span<const std::byte> lhs, const std::span<const std::byte> rhs) noexcept
+    {
+        const auto  n = std::min(lhs.size(), rhs.size());
+        const auto* a = lhs.data();
+        const auto* b = rhs.data();
+        size_t      i = 0;
+
+#ifdef BETTERTEST_DIFF_SSE2
+        // Compare 64 bytes per iteration, then locate the mismatch in the failing block.
+        for (; i + 64 <= n; i += 64)
+        {
+            if ((equalMask(a + i, b + i) & equalMask(a + i + 16, b + i + 16) & equalMask(a + i + 32, b + i + 32) &
+                 equalMask(a + i + 48, b + i + 48)) != 0xFFFF)
+                break;
+        }
+        for (; i + 16 <= n; i += 16)
+        {
+            if (const auto mask = equalMask(a + i, b + i); mask != 0xFFFF) return i + std::countr_one(mask);
+        }
+#endif
+
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            for (; i + 8 <= n; i += 8)
+            {
+                if (const auto x = loadWord(a + i) ^ loadWord(b + i); x != 0) return i + std::countr_zero(x) / 8;
+            }
+        }
+
+        for (; i < n; i++)
+            if (a[i] != b[i]) return i;
+
+        return n;
+    }
+
+    size_t findCommonSuffix(const std::span<const std::byte> lhs, const std::span<const std::byte> rhs) noexcept
+    {
+        const auto  n = std::min(lhs.size(), rhs.size());
+        const auto* a = lhs.data() + lhs.size();
+        const auto* b = rhs.data() + rhs.size();
+        size_t      i = 0;
+
+#ifdef BETTERTEST_DIFF_SSE2
+        for (; i + 64 <= n; i += 64)
+        {
+            if ((equalMask(a - i - 16, b - i - 16) & equalMask(a - i - 32, b - i - 32) &
+                 equalMask(a - i - 48, b - i - 48) & equalMask(a - i - 64, b - i - 64)) != 0xFFFF)
+                break;
+        }
+        for (; i + 16 <= n; i += 16)
+        {
+            if (const auto mask = equalMask(a - i - 16, b - i - 16); mask != 0xFFFF)
+                return i + std::countl_one(static_cast<uint16_t>(mask));
+        }
+#endif
+
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            for (; i + 8 <= n; i += 8)
+            {
+                if (const auto x = loadWord(a - i - 8) ^ loadWord(b - i - 8); x != 0)
+                    return i + std::countl_zero(x) / 8;
+            }
+        }
+
+        for (; i < n; i++)
+            if (*(a - i - 1) != *(b - i - 1)) return i;
+
+        return n;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Diff.
+    ////////////////////////////////////////////////////////////////
+
+    std::string diffText(const std::string_view lhs, const std::string_view rhs, const DiffOptions& options)
+    {
+        const auto first = findFirstMismatch(asBytes(lhs), asBytes(rhs));
+        if (first == lhs.size() && first == rhs.size()) return {};
+
+        // Start of the line containing the first mismatch. The prefix is shared, so it is the same for both sides.
+        const auto lineStart  = first == 0 ? 0 : lhs.rfind('\n', first - 1) + 1;
+        const auto lineNumber = static_cast<size_t>(std::ranges::count(lhs.substr(0, lineStart), '\n')) + 1;
+
+        // End of the changed region, extended to the end of its line. The suffix is shared as well.
+        const auto lhsTail = lhs.substr(lineStart);
+        const auto rhsTail = rhs.substr(lineStart);
+        const auto suffix  = findCommonSuffix(asBytes(lhsTail), asBytes(rhsTail));
+        auto       extend  = lhsTail.substr(lhsTail.size() - suffix).find('\n');
+        extend             = extend == std::string_view::npos ? suffix : extend + 1;
+        const auto lhsRegion = lhsTail.substr(0, lhsTail.size() - suffix + extend);
+        const auto rhsRegion = rhsTail.substr(0, rhsTail.size() - suffix + extend);
+
+        std::string out = std::format("strings differ: length lhs[{0}], length rhs[{1}], first mismatch at offset {2} "
+                                      "(line {3}, column {4})",
+                                      lhs.size(),
+                                      rhs.size(),
+                                      first,
+                                      lineNumber,
+                                      first - lineStart + 1);
+
+        // Excerpt around the first mismatch.
+        constexpr size_t excerpt = 32;
+        const auto       from    = first > excerpt ? first - excerpt : 0;
+        out += std::format("\n    lhs: \"{0}\"", escape(lhs.substr(from, first - from + excerpt)));
+        out += std::format("\n    rhs: \"{0}\"", escape(rhs.substr(from, first - from + excerpt)));
+
+        // Map lines to identifiers so that the diff compares integers.
+        bool       truncated = false;
+        const auto lhsLines  = splitLines(lhsRegion, options.window, truncated);
+        const auto rhsLines  = splitLines(rhsRegion, options.window, truncated);
+        std::unordered_map<std::string_view, uint32_t> ids;
+        const auto                                     toIds = [&ids](const std::vector<std::string_view>& lines) {
+            std::vector<uint32_t> res;
+            res.reserve(lines.size());
+            for (const auto l : lines)
+                res.push_back(ids.try_emplace(l, static_cast<uint32_t>(ids.size())).first->second);
+            return res;
+        };
+        const auto lhsIds = toIds(lhsLines);
+        const auto rhsIds = toIds(rhsLines);
+
+        const auto writeRun = [&](std::string& s, const Op op, const Edit* begin, const Edit* end, const size_t max) {
+            const auto count = std::min(static_cast<size_t>(end - begin), max);
+            for (auto e = begin; e != begin + count; ++e)
+            {
+                const auto line = op == Op::Insert ? rhsLines[e->b] : lhsLines[e->a];
+                s += std::format("\n{0}{1}{2}",
+                                 prefix(op),
+                                 escape(line.substr(0, options.maxLineLength)),
+                                 line.size() > options.maxLineLength ? "..." : "");
+            }
+            return std::make_pair(count, count);
+        };
+
+        const auto edits = MyersDiff(lhsIds, rhsIds)();
+        if (!writeHunks(out, edits, lineNumber, lineNumber, options.context, options.maxOutputLines, writeRun))
+            out += "\n... diff truncated";
+        if (truncated)
+            out += std::format("\n... changed region exceeds {0} lines, remaining changes not shown", options.window);
+
+        return out;
+    }
+
+    std::string
+      diffBytes(const std::span<const std::byte> lhs, const std::span<const std::byte> rhs, const DiffOptions& options)
+    {
+        const auto first = findFirstMismatch(lhs, rhs);
+        if (first == lhs.size() && first == rhs.size()) return {};
+
+        // Align rows of 16 bytes to keep offsets readable.
+        constexpr size_t row    = 16;
+        const auto       start  = first / row * row;
+        const auto       suffix = findCommonSuffix(lhs.subspan(start), rhs.subspan(start));
+        const auto       lhsLen = std::min(lhs.size() - start - suffix + row, lhs.size() - start);
+        const auto       rhsLen = std::min(rhs.size() - start - suffix + row, rhs.size() - start);
+
+        std::string out =
+          std::format("byte spans differ: length lhs[{0}], length rhs[{1}], first mismatch at offset {2}",
+                      lhs.size(),
+                      rhs.size(),
+                      first);
+
+        const auto toIds = [&](const std::span<const std::byte> bytes, const size_t len) {
+            std::vector<uint32_t> ids(std::min(len, options.window));
+            for (size_t i = 0; i < ids.size(); i++) ids[i] = static_cast<uint32_t>(bytes[start + i]);
+            return ids;
+        };
+        const auto lhsIds = toIds(lhs, lhsLen);
+        const auto rhsIds = toIds(rhs, rhsLen);
+
+        // Print each run as rows of up to 16 bytes, prefixed with the offset of the first byte.
+        const auto writeRun = [&](std::string& s, const Op op, const Edit* begin, const Edit* end, const size_t max) {
+            const auto& ids   = op == Op::Insert ? rhsIds : lhsIds;
+            size_t      lines = 0;
+            auto        e     = begin;
+            for (; e != end && lines < max; lines++)
+            {
+                const auto index = op == Op::Insert ? e->b : e->a;
+                s += std::format("\n{0}{1:08x}:", prefix(op), start + index);
+                for (size_t i = index; e != std::min(end, begin + (lines + 1) * row); ++e, ++i)
+                    s += std::format(" {0:02x}", ids[i]);
+            }
+            return std::make_pair(static_cast<size_t>(e - begin), lines);
+        };
+
+        // Byte offsets in hunk headers are 0-based, so pass start as the offset of the first element.
+        const auto edits = MyersDiff(lhsIds, rhsIds)();
+        if (!writeHunks(out, edits, start, start, options.context * row, options.maxOutputLines, writeRun))
+            out += "\n... diff truncated";
+        if (lhsLen > options.window || rhsLen > options.window)
+            out += std::format("\n... changed region exceeds {0} bytes, remaining changes not shown", options.window);
+
+        return out;
+    }
+}  // namespace bt
@@ -0,0 +1,220 @@
+#include "bettertest/utils/environment.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace
+{
+    /**
+     * \brief Load average above which a machine with few hardware threads is considered busy. The benchmark process
+     * itself accounts for 1.
+     */
+    constexpr double minLoadThreshold = 1.5;
+
+    /**
+     * \brief Load average per hardware thread above which the machine is considered busy. Shared machines always run
+     * other work, but it only disturbs measurements once it competes for a large part of the CPUs.
+     */
+    constexpr double maxLoadPerThread = 0.5;
+
+    [[nodiscard]] std::optional<std::string> readLine(const std::string& path)
+    {
+        std::ifstream file(path);
+        if (std::string line; file && std::getline(file, line)) return line;
+        return std::nullopt;
+    }
+
+#ifdef __linux__
+    /**
+     * \brief Affinity mask from before the active CpuPinning. Restored by its destructor and by unpinThread. Written
+     * only while no worker threads exist.
+     */
+    std::optional<cpu_set_t> unpinnedAffinity;
+
+    /**
+     * \brief Parse a CPU list such as "2,4-7" and return the first CPU.
+     */
+    [[nodiscard]] int32_t firstCpuInList(const std::string& list)
+    {
+        int32_t cpu = -1;
+        if (std::istringstream(list) >> cpu) return cpu;
+        return -1;
+    }
+#endif
+}  // namespace
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // CpuPinning.
+    ////////////////////////////////////////////////////////////////
+
+    CpuPinning::CpuPinning()
+    {
+#ifdef __linux__
+        cpu_set_t current;
+        CPU_ZERO(&current);
+        if (sched_getaffinity(0, sizeof(current), &current) != 0) return;
+
+        // Prefer an isolated CPU, as nothing else is scheduled on it. Isolated CPUs are not part of the default
+        // affinity mask, so they are not checked against it.
+        auto target = -1;
+        if (const auto list = readLine("/sys/devices/system/cpu/isolated"))
+        {
+            target   = firstCpuInList(*list);
+            isolated = target != -1;
+        }
+        if (target == -1) target = sched_getcpu();
+        if (target < 0 || target >= CPU_SETSIZE) return;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(target, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        {
+            isolated = false;
+            return;
+        }
+
+        cpu              = target;
+        unpinnedAffinity = current;
+#endif
+    }
+
+    CpuPinning::~CpuPinning() noexcept
+    {
+#ifdef __linux__
+        if (cpu == -1) return;
+        unpinThread();
+        unpinnedAffinity.reset();
+#endif
+    }
+
+    int32_t CpuPinning::getCpu() const noexcept { return cpu; }
+
+    bool CpuPinning::isIsolated() const noexcept { return isolated; }
+
+    ////////////////////////////////////////////////////////////////
+    // CpuUnpinning.
+    ////////////////////////////////////////////////////////////////
+
+    CpuUnpinning::CpuUnpinning() noexcept
+    {
+#ifdef __linux__
+        if (!unpinnedAffinity) return;
+
+        // Only lift pinning from a thread that is pinned to a single CPU.
+        cpu_set_t current;
+        CPU_ZERO(&current);
+        if (sched_getaffinity(0, sizeof(current), &current) != 0 || CPU_COUNT(&current) != 1) return;
+        for (int32_t i = 0; i < CPU_SETSIZE && cpu == -1; i++)
+            if (CPU_ISSET(i, &current)) cpu = i;
+
+        unpinThread();
+#endif
+    }
+
+    CpuUnpinning::~CpuUnpinning() noexcept
+    {
+#ifdef __linux__
+        if (cpu == -1) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+#endif
+    }
+
+    bool isCpuPinningSupported() noexcept
+    {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void unpinThread() noexcept
+    {
+#ifdef __linux__
+        if (unpinnedAffinity) sched_setaffinity(0, sizeof(*unpinnedAffinity), &*unpinnedAffinity);
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Inspection.
+    ////////////////////////////////////////////////////////////////
+
+    BenchmarkEnvironment inspectEnvironment(const CpuPinning& pinning)
+    {
+        BenchmarkEnvironment env;
+        env.cpu      = pinning.getCpu();
+        env.isolated = pinning.isIsolated();
+
+        // Without support for pinning the scheduler may migrate tests, which adds noise but is no failure.
+        if (!isCpuPinningSupported())
+            env.warnings.emplace_back("Pinning performance tests to a CPU is not supported on this platform");
+        else if (env.cpu == -1)
+            env.errors.emplace_back("Could not pin performance tests to a CPU");
+
+        // Frequency scaling governor.
+        const auto cpu = env.cpu == -1 ? 0 : env.cpu;
+        if (const auto governor = readLine(std::format("/sys/devices/system/cpu/cpu{}/cpufreq/scaling_governor", cpu)))
+        {
+            env.governor = *governor;
+            if (env.governor != "performance")
+                env.warnings.emplace_back(
+                  std::format("CPU frequency scaling governor is \"{}\" instead of \"performance\"", env.governor));
+        }
+
+        // Turbo boost. Intel P-state exposes a no_turbo flag, other drivers a boost flag.
+        if (const auto noTurbo = readLine("/sys/devices/system/cpu/intel_pstate/no_turbo"))
+            env.turbo = *noTurbo == "0";
+        else if (const auto boost = readLine("/sys/devices/system/cpu/cpufreq/boost"))
+            env.turbo = *boost == "1";
+        if (env.turbo.value_or(false)) env.warnings.emplace_back("Turbo boost is enabled");
+
+        // System load.
+        if (const auto load = readLine("/proc/loadavg"))
+        {
+            double value = 0;
+            if (std::istringstream(*load) >> value) env.loadAverage = value;
+
+            // The load average counts tasks of all CPUs, so scale the threshold with their number.
+            const auto threads   = std::max(std::thread::hardware_concurrency(), 1u);
+            const auto threshold = std::max(minLoadThreshold, maxLoadPerThread * threads);
+            if (env.loadAverage.value_or(0) > threshold)
+                env.errors.emplace_back(
+                  std::format("Load average is {:.2f} on {} hardware threads", *env.loadAverage, threads));
+        }
+
+        return env;
+    }
+
+    uint64_t readThrottleCount()
+    {
+#ifdef __linux__
+        const auto cpu = sched_getcpu();
+        if (cpu < 0) return 0;
+
+        uint64_t count = 0;
+        if (const auto line =
+              readLine(std::format("/sys/devices/system/cpu/cpu{}/thermal_throttle/core_throttle_count", cpu)))
+            std::istringstream(*line) >> count;
+        return count;
+#else
+        return 0;
+#endif
+    }
+}  // namespace bt
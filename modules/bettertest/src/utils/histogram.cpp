@@ -0,0 +1,268 @@
+#include "bettertest/utils/histogram.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+namespace
+{
+    constexpr std::string_view base64Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    void writeVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    [[nodiscard]] std::optional<uint64_t> readVarint(std::string_view& in)
+    {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64 && !in.empty(); shift += 7)
+        {
+            const auto byte = static_cast<uint8_t>(in.front());
+            in.remove_prefix(1);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        return std::nullopt;
+    }
+
+    // Zigzag encoding maps small negative and positive numbers to small unsigned numbers.
+    [[nodiscard]] uint64_t zigzag(const int64_t value) noexcept
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    [[nodiscard]] int64_t unzigzag(const uint64_t value) noexcept
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    [[nodiscard]] std::string encodeBase64(const std::string_view bytes)
+    {
+        std::string out;
+        out.reserve((bytes.size() + 2) / 3 * 4);
+        for (size_t i = 0; i < bytes.size(); i += 3)
+        {
+            const auto remaining = bytes.size() - i;
+            uint32_t   triple    = static_cast<uint32_t>(static_cast<uint8_t>(bytes[i])) << 16;
+            if (remaining > 1) triple |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i + 1])) << 8;
+            if (remaining > 2) triple |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i + 2]));
+
+            out.push_back(base64Alphabet[(triple >> 18) & 0x3f]);
+            out.push_back(base64Alphabet[(triple >> 12) & 0x3f]);
+            out.push_back(remaining > 1 ? base64Alphabet[(triple >> 6) & 0x3f] : '=');
+            out.push_back(remaining > 2 ? base64Alphabet[triple & 0x3f] : '=');
+        }
+        return out;
+    }
+
+    [[nodiscard]] std::optional<std::string> decodeBase64(const std::string_view text)
+    {
+        if (text.size() % 4 != 0) return std::nullopt;
+
+        std::string out;
+        out.reserve(text.size() / 4 * 3);
+        for (size_t i = 0; i < text.size(); i += 4)
+        {
+            uint32_t triple  = 0;
+            size_t   padding = 0;
+            for (size_t j = 0; j < 4; j++)
+            {
+                triple <<= 6;
+                if (text[i + j] == '=' && i + 4 == text.size() && j >= 2)
+                {
+                    padding++;
+                    continue;
+                }
+                if (padding > 0) return std::nullopt;
+                const auto pos = base64Alphabet.find(text[i + j]);
+                if (pos == std::string_view::npos) return std::nullopt;
+                triple |= static_cast<uint32_t>(pos);
+            }
+
+            out.push_back(static_cast<char>((triple >> 16) & 0xff));
+            if (padding < 2) out.push_back(static_cast<char>((triple >> 8) & 0xff));
+            if (padding < 1) out.push_back(static_cast<char>(triple & 0xff));
+        }
+        return out;
+    }
+}  // namespace
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    Histogram::Histogram(const uint64_t highest, const uint32_t significantDigits) :
+        highest(std::max<uint64_t>(highest, 2)), significantDigits(std::clamp<uint32_t>(significantDigits, 1, 5))
+    {
+        // Smallest power of 2 that distinguishes all values up to 2 * 10^digits, so that each bucket, covering a
+        // factor of 2, has a resolution of at least the requested number of digits.
+        const auto resolution = 2 * static_cast<uint64_t>(std::pow(10, this->significantDigits));
+        subBucketMagnitude    = static_cast<uint32_t>(std::bit_width(resolution - 1));
+        subBucketCount        = uint64_t{1} << subBucketMagnitude;
+        subBucketMask         = subBucketCount - 1;
+
+        // Add buckets until the highest value is covered.
+        size_t buckets             = 1;
+        auto   smallestUntrackable = subBucketCount;
+        while (smallestUntrackable <= this->highest)
+        {
+            buckets++;
+            if (smallestUntrackable > UINT64_MAX / 2) break;
+            smallestUntrackable <<= 1;
+        }
+
+        counts.resize((buckets + 1) * (subBucketCount / 2));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    uint64_t Histogram::getValueAtPercentile(const double percentile) const noexcept
+    {
+        if (totalCount == 0) return 0;
+
+        const auto fraction = std::clamp(percentile, 0.0, 100.0) / 100;
+        const auto target   = std::max<uint64_t>(
+          1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(totalCount))));
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < counts.size(); i++)
+        {
+            cumulative += counts[i];
+            if (cumulative >= target) return std::min(getHighestEquivalentValue(getValueFromIndex(i)), max);
+        }
+
+        return max;
+    }
+
+    uint64_t Histogram::getValueFromIndex(const size_t index) const noexcept
+    {
+        const auto halfMagnitude = subBucketMagnitude - 1;
+        const auto halfCount     = subBucketCount >> 1;
+        auto       bucket        = static_cast<int64_t>(index >> halfMagnitude) - 1;
+        auto       subBucket     = (index & (halfCount - 1)) + halfCount;
+        if (bucket < 0)
+        {
+            subBucket -= halfCount;
+            bucket = 0;
+        }
+        return subBucket << bucket;
+    }
+
+    uint64_t Histogram::getHighestEquivalentValue(const uint64_t value) const noexcept
+    {
+        const auto bucket = static_cast<uint32_t>(std::bit_width(value | subBucketMask)) - subBucketMagnitude;
+        const auto lowest = (value >> bucket) << bucket;
+        return lowest + (uint64_t{1} << bucket) - 1;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Recording.
+    ////////////////////////////////////////////////////////////////
+
+    bool Histogram::merge(const Histogram& other) noexcept
+    {
+        if (other.highest != highest || other.significantDigits != significantDigits) return false;
+
+        for (size_t i = 0; i < counts.size(); i++) counts[i] += other.counts[i];
+        totalCount += other.totalCount;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+
+        return true;
+    }
+
+    void Histogram::reset() noexcept
+    {
+        std::ranges::fill(counts, 0);
+        totalCount = 0;
+        min        = UINT64_MAX;
+        max        = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Encoding.
+    ////////////////////////////////////////////////////////////////
+
+    std::string Histogram::encode() const
+    {
+        std::string bytes;
+        writeVarint(bytes, significantDigits);
+        writeVarint(bytes, highest);
+        writeVarint(bytes, getMin());
+        writeVarint(bytes, max);
+
+        // Write counts up to the last non-empty bucket. A run of empty buckets is written as its negated length.
+        const auto last = std::ranges::find_if(counts.rbegin(), counts.rend(), [](const uint64_t c) { return c != 0; });
+        const auto end  = static_cast<size_t>(counts.rend() - last);
+        for (size_t i = 0; i < end;)
+        {
+            if (counts[i] != 0)
+            {
+                writeVarint(bytes, zigzag(static_cast<int64_t>(counts[i++])));
+                continue;
+            }
+
+            int64_t run = 0;
+            while (i < end && counts[i] == 0)
+            {
+                run++;
+                i++;
+            }
+            writeVarint(bytes, zigzag(-run));
+        }
+
+        return encodeBase64(bytes);
+    }
+
+    std::optional<Histogram> Histogram::decode(const std::string_view encoded)
+    {
+        const auto bytes = decodeBase64(encoded);
+        if (!bytes) return std::nullopt;
+
+        std::string_view in(*bytes);
+        const auto       digits  = readVarint(in);
+        const auto       highest = readVarint(in);
+        const auto       min     = readVarint(in);
+        const auto       max     = readVarint(in);
+        if (!digits || !highest || !min || !max || *digits < 1 || *digits > 5) return std::nullopt;
+
+        Histogram histogram(*highest, static_cast<uint32_t>(*digits));
+        size_t    index = 0;
+        while (!in.empty())
+        {
+            const auto value = readVarint(in);
+            if (!value) return std::nullopt;
+
+            const auto count = unzigzag(*value);
+            if (count < 0)
+                index += static_cast<size_t>(-count);
+            else if (index < histogram.counts.size())
+            {
+                histogram.counts[index++] = static_cast<uint64_t>(count);
+                histogram.totalCount += static_cast<uint64_t>(count);
+            }
+            else
+                return std::nullopt;
+        }
+
+        if (histogram.totalCount > 0)
+        {
+            histogram.min = *min;
+            histogram.max = *max;
+        }
+
+        return histogram;
+    }
+}  // namespace bt
@@ -0,0 +1,303 @@
+#include "bettertest/utils/isolation.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <format>
+#include <sstream>
+
+#ifdef __linux__
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace
+{
+    /**
+     * \brief Exit code of a child process that could not allocate memory.
+     */
+    constexpr int memoryLimitExitCode = 87;
+
+    /**
+     * \brief Held while creating a pipe and child process, so that no other child inherits the write end of the pipe
+     * and keeps it open.
+     */
+    std::mutex forkMutex;
+
+    [[noreturn]] void onOutOfMemory() { _exit(memoryLimitExitCode); }
+
+    /**
+     * \brief Get the size of the address space of the calling process.
+     * \return Size in bytes, or 0 if it could not be determined.
+     */
+    [[nodiscard]] uint64_t getAddressSpaceSize() noexcept
+    {
+        // Read /proc/self/statm without allocating. The first field is the number of pages.
+        const int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return 0;
+        char       buffer[64] = {};
+        const auto n          = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (n <= 0) return 0;
+
+        uint64_t pages = 0;
+        for (const char* c = buffer; *c >= '0' && *c <= '9'; c++)
+            pages = pages * 10 + static_cast<uint64_t>(*c - '0');
+        return pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    /**
+     * \brief Get the highest file descriptor that is open in the calling process.
+     * \return File descriptor, or -1 if it could not be determined.
+     */
+    [[nodiscard]] int getHighestFileDescriptor() noexcept
+    {
+        DIR* dir = opendir("/proc/self/fd");
+        if (!dir) return -1;
+        int highest = -1;
+        while (const auto* entry = readdir(dir))
+        {
+            if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+            highest = std::max(highest, std::atoi(entry->d_name));
+        }
+        closedir(dir);
+        return highest;
+    }
+
+    void setLimit(const int resource, const rlim_t soft, const rlim_t hard) noexcept
+    {
+        const rlimit limit{.rlim_cur = soft, .rlim_max = hard};
+        setrlimit(resource, &limit);
+    }
+
+    void applyLimits(const bt::ResourceLimits& limits) noexcept
+    {
+        // Address space and file descriptors are inherited from the parent, so the limits are relative to the current
+        // usage.
+        if (limits.memory)
+        {
+            const auto size = getAddressSpaceSize() + limits.memory;
+            setLimit(RLIMIT_AS, size, size);
+            std::set_new_handler(onOutOfMemory);
+        }
+
+        // SIGXCPU is raised at the soft limit, SIGKILL one second later at the hard limit.
+        if (limits.cpuSeconds) setLimit(RLIMIT_CPU, limits.cpuSeconds, limits.cpuSeconds + 1);
+
+        if (limits.openFiles)
+        {
+            const auto count = static_cast<rlim_t>(getHighestFileDescriptor() + 1) + limits.openFiles;
+            setLimit(RLIMIT_NOFILE, count, count);
+        }
+    }
+
+    /**
+     * \brief Returns whether the calling process cannot open more files.
+     */
+    [[nodiscard]] bool isFileLimitReached() noexcept
+    {
+        const int fd = dup(STDERR_FILENO);
+        if (fd < 0) return errno == EMFILE;
+        close(fd);
+        return false;
+    }
+
+    [[nodiscard]] bool writeAll(const int fd, const char* data, size_t size) noexcept
+    {
+        while (size > 0)
+        {
+            const auto n = write(fd, data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * \brief Read until the other end closes the pipe or the deadline passes.
+     * \param fd Read end of the pipe.
+     * \param data Data read.
+     * \param deadline Deadline.
+     * \return True if the pipe was closed, false if the deadline passed first.
+     */
+    [[nodiscard]] bool
+      readAll(const int fd, std::string& data, const std::chrono::steady_clock::time_point deadline)
+    {
+        char buffer[4096];
+        while (true)
+        {
+            const auto remaining =
+              std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) return false;
+
+            pollfd p{.fd = fd, .events = POLLIN, .revents = 0};
+            const auto ready = poll(&p, 1, static_cast<int>(std::min<int64_t>(remaining, INT_MAX)));
+            if (ready < 0 && errno == EINTR) continue;
+            if (ready == 0) continue;
+            if (ready < 0) return true;
+
+            const auto n = read(fd, buffer, sizeof(buffer));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return true;
+            data.append(buffer, static_cast<size_t>(n));
+        }
+    }
+
+    /**
+     * \brief Run the function in the child process and write the result to the pipe. Message layout: passing state (1
+     * byte), failure reason (1 byte), size of the error message (8 bytes), error message, output.
+     */
+    [[noreturn]] void runChild(const bt::isolated_function_t& f, const bt::ResourceLimits& limits, const int fd)
+    {
+        applyLimits(limits);
+
+        std::stringstream ss;
+        auto [pass, error] = f(ss);
+
+        // Running out of files does not terminate the process, so check whether the test failed because of it.
+        auto failure = pass ? bt::failure_t::none : bt::failure_t::failed;
+        if (!pass && limits.openFiles && isFileLimitReached())
+        {
+            failure = bt::failure_t::file_limit;
+            if (!error.empty()) error += "\n";
+            error += std::format("The test exceeded its open file limit of {}", limits.openFiles);
+        }
+
+        const auto     output    = ss.str();
+        const uint64_t errorSize = error.size();
+        std::string    message;
+        message += static_cast<char>(pass);
+        message += static_cast<char>(failure);
+        message.append(reinterpret_cast<const char*>(&errorSize), sizeof(errorSize));
+        message += error;
+        message += output;
+
+        // Exit without running destructors of static objects, which belong to the parent.
+        _exit(writeAll(fd, message.data(), message.size()) ? 0 : 1);
+    }
+
+    [[nodiscard]] bt::IsolatedResult makeFailure(std::string error, const bt::failure_t failure)
+    {
+        bt::IsolatedResult result;
+        result.error   = std::move(error);
+        result.failure = failure;
+        return result;
+    }
+
+    [[nodiscard]] bt::IsolatedResult readResult(const std::string& message)
+    {
+        constexpr size_t headerSize = 2 + sizeof(uint64_t);
+        uint64_t         errorSize  = 0;
+        if (message.size() >= headerSize) std::memcpy(&errorSize, message.data() + 2, sizeof(errorSize));
+        if (message.size() < headerSize || message.size() - headerSize < errorSize)
+            return makeFailure("The test process exited without reporting a result", bt::failure_t::crashed);
+
+        bt::IsolatedResult result;
+        result.pass    = message[0] != 0;
+        result.failure = static_cast<bt::failure_t>(message[1]);
+        result.error   = message.substr(headerSize, errorSize);
+        result.output  = message.substr(headerSize + errorSize);
+        return result;
+    }
+}  // namespace
+#endif
+
+namespace bt
+{
+    bool isIsolationSupported() noexcept
+    {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    IsolatedResult runIsolated(const isolated_function_t& f, const ResourceLimits& limits)
+    {
+#ifdef __linux__
+        int   fds[2] = {-1, -1};
+        pid_t pid    = -1;
+        {
+            std::scoped_lock lock(forkMutex);
+            if (pipe2(fds, O_CLOEXEC) != 0)
+                return makeFailure("Could not create a pipe to the test process", failure_t::failed);
+
+            pid = fork();
+            if (pid == 0)
+            {
+                close(fds[0]);
+                runChild(f, limits, fds[1]);
+            }
+            close(fds[1]);
+        }
+
+        if (pid < 0)
+        {
+            close(fds[0]);
+            return makeFailure("Could not create the test process", failure_t::failed);
+        }
+
+        // Read until the child closes the pipe, then collect its exit status. A child that does not finish in time,
+        // for example because it deadlocked after fork, is killed.
+        const auto  timeout  = limits.wallSeconds ? limits.wallSeconds : isolatedTimeout;
+        const auto  deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+        std::string message;
+        const auto  finished = readAll(fds[0], message, deadline);
+        close(fds[0]);
+        if (!finished) kill(pid, SIGKILL);
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+        if (!finished)
+            return makeFailure(std::format("The test did not finish within its time limit of {} s", timeout),
+                               failure_t::time_limit);
+
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) return readResult(message);
+
+        if (WIFEXITED(status) && WEXITSTATUS(status) == memoryLimitExitCode && limits.memory)
+            return makeFailure(std::format("The test exceeded its memory limit of {} bytes", limits.memory),
+                               failure_t::memory_limit);
+
+        if (WIFSIGNALED(status))
+        {
+            const auto sig = WTERMSIG(status);
+            if ((sig == SIGXCPU || sig == SIGKILL) && limits.cpuSeconds)
+                return makeFailure(std::format("The test exceeded its CPU time limit of {} s", limits.cpuSeconds),
+                                   failure_t::cpu_limit);
+            return makeFailure(std::format("The test process was terminated by signal {} ({})", sig, strsignal(sig)),
+                               failure_t::crashed);
+        }
+
+        return makeFailure(std::format("The test process exited with code {}", WEXITSTATUS(status)),
+                           failure_t::crashed);
+#else
+        // Run in this process without limits.
+        static_cast<void>(limits);
+        std::stringstream ss;
+        auto [pass, error] = f(ss);
+        return {.pass    = pass,
+                .error   = std::move(error),
+                .output  = ss.str(),
+                .failure = pass ? failure_t::none : failure_t::failed};
+#endif
+    }
+}  // namespace bt
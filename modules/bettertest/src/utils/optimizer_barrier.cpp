@@ -0,0 +1,6 @@
+#include "bettertest/utils/optimizer_barrier.h"
+
+namespace bt::internal
+{
+    void useCharPointer(const volatile char* ptr) noexcept { static_cast<void>(ptr); }
+}  // namespace bt::internal
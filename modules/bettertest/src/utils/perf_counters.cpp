@@ -0,0 +1,187 @@
+#include "bettertest/utils/perf_counters.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /**
+     * \brief Get the CPU time of the calling thread in nanoseconds. Used if the task clock event cannot be opened.
+     */
+    [[nodiscard]] uint64_t threadCpuTime() noexcept
+    {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+        timespec ts{};
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+            return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+        return static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+    }
+
+#ifdef __linux__
+    [[nodiscard]] int openEvent(const uint32_t type, const uint64_t config, const int groupFd) noexcept
+    {
+        perf_event_attr attr{};
+        attr.type           = type;
+        attr.size           = sizeof(perf_event_attr);
+        attr.config         = config;
+        attr.disabled       = groupFd == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Measure the calling thread on any CPU.
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    constexpr std::array<uint64_t, 4> hardwareEvents = {
+      PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+#endif
+}  // namespace
+
+namespace bt
+{
+    std::optional<uint64_t> PerfCounts::get(const perf_event_t event) const noexcept
+    {
+        switch (event)
+        {
+        case perf_event_t::instructions: return instructions;
+        case perf_event_t::cycles: return cycles;
+        case perf_event_t::cache_misses: return cacheMisses;
+        case perf_event_t::branch_misses: return branchMisses;
+        default: return std::nullopt;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    PerfCounters::PerfCounters() noexcept
+    {
+        fds.fill(-1);
+
+#ifdef __linux__
+        // Open hardware events as a single group, so that they are scheduled together. Events that are not supported
+        // by the CPU (common in virtual machines) are left out.
+        int leader = -1;
+        for (size_t i = 0; i < eventCount; i++)
+        {
+            fds[i] = openEvent(PERF_TYPE_HARDWARE, hardwareEvents[i], leader);
+            if (leader == -1) leader = fds[i];
+        }
+
+        clockFd = openEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, -1);
+#endif
+    }
+
+    PerfCounters::~PerfCounters() noexcept
+    {
+#ifdef __linux__
+        // Close members before the leader.
+        for (auto it = fds.rbegin(); it != fds.rend(); ++it)
+            if (*it != -1) close(*it);
+        if (clockFd != -1) close(clockFd);
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    bool PerfCounters::hasHardwareCounters() const noexcept
+    {
+        return std::ranges::any_of(fds, [](const int fd) { return fd != -1; });
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Measuring.
+    ////////////////////////////////////////////////////////////////
+
+    void PerfCounters::start() noexcept
+    {
+#ifdef __linux__
+        if (const auto it = std::ranges::find_if(fds, [](const int fd) { return fd != -1; }); it != fds.end())
+        {
+            ioctl(*it, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(*it, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+        if (clockFd != -1)
+        {
+            ioctl(clockFd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(clockFd, PERF_EVENT_IOC_ENABLE, 0);
+            return;
+        }
+#endif
+        clockStart = threadCpuTime();
+    }
+
+    PerfCounts PerfCounters::stop() noexcept
+    {
+        PerfCounts counts;
+
+#ifdef __linux__
+        // Layout of a read with PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING.
+        struct
+        {
+            uint64_t nr;
+            uint64_t timeEnabled;
+            uint64_t timeRunning;
+            uint64_t values[eventCount];
+        } data{};
+
+        // Scale counts if the group was not scheduled on the PMU all the time.
+        const auto scale = [&](const uint64_t value) {
+            if (data.timeRunning == 0 || data.timeRunning >= data.timeEnabled) return value;
+            return static_cast<uint64_t>(static_cast<double>(value) * static_cast<double>(data.timeEnabled) /
+                                         static_cast<double>(data.timeRunning));
+        };
+
+        if (clockFd != -1) ioctl(clockFd, PERF_EVENT_IOC_DISABLE, 0);
+
+        if (const auto it = std::ranges::find_if(fds, [](const int fd) { return fd != -1; }); it != fds.end())
+        {
+            ioctl(*it, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            if (read(*it, &data, sizeof(data)) > 0 && data.timeRunning > 0)
+            {
+                // Values are in order of opening, which skips events that could not be opened.
+                std::array<std::optional<uint64_t>*, eventCount> dst = {
+                  &counts.instructions, &counts.cycles, &counts.cacheMisses, &counts.branchMisses};
+                size_t j = 0;
+                for (size_t i = 0; i < eventCount && j < data.nr; i++)
+                    if (fds[i] != -1) *dst[i] = scale(data.values[j++]);
+            }
+        }
+
+        if (clockFd != -1)
+        {
+            struct
+            {
+                uint64_t nr;
+                uint64_t timeEnabled;
+                uint64_t timeRunning;
+                uint64_t value;
+            } clock{};
+            if (read(clockFd, &clock, sizeof(clock)) > 0) counts.taskClock = clock.value;
+            return counts;
+        }
+#endif
+
+        counts.taskClock = threadCpuTime() - clockStart;
+        return counts;
+    }
+}  // namespace bt
@@ -0,0 +1,317 @@
+#include "bettertest/utils/profiler.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined __linux__ && (defined __x86_64__ || defined __aarch64__)
+#define BETTERTEST_SAMPLING_PROFILER
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+// Older glibc versions only declare the union member.
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+
+namespace bt
+{
+    struct SamplingProfiler::State
+    {
+        uint32_t frequency = 0;
+        size_t   capacity  = 0;
+        size_t   maxDepth  = 0;
+
+        /**
+         * \brief Return addresses of all samples, maxDepth entries per sample.
+         */
+        std::vector<uintptr_t> frames;
+
+        /**
+         * \brief Number of frames of each sample. Written last by the signal handler, so 0 marks an incomplete sample.
+         */
+        std::unique_ptr<std::atomic<uint32_t>[]> depths;
+
+        std::atomic<size_t> next    = 0;
+        std::atomic<size_t> dropped = 0;
+
+        /**
+         * \brief Id and stack bounds of the sampled thread.
+         */
+        long      thread    = 0;
+        uintptr_t stackLow  = 0;
+        uintptr_t stackHigh = 0;
+
+        bool running = false;
+
+#ifdef BETTERTEST_SAMPLING_PROFILER
+        struct sigaction previousAction = {};
+        timer_t          timer          = {};
+#endif
+    };
+}  // namespace bt
+
+namespace
+{
+    static_assert(std::atomic<size_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "Atomics used in the signal handler must be lock free");
+
+    /**
+     * \brief State of the active profiler, read by the signal handler.
+     */
+    std::atomic<bt::SamplingProfiler::State*> activeProfiler = nullptr;
+
+#ifdef BETTERTEST_SAMPLING_PROFILER
+    void handleSignal(int, siginfo_t*, void* context)
+    {
+        auto* state = activeProfiler.load(std::memory_order_acquire);
+        if (!state || syscall(SYS_gettid) != state->thread) return;
+
+        const auto savedErrno = errno;
+        const auto index      = state->next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= state->capacity)
+        {
+            state->dropped.fetch_add(1, std::memory_order_relaxed);
+            errno = savedErrno;
+            return;
+        }
+
+        // Read program counter and frame pointer of the interrupted code.
+        const auto& mcontext = static_cast<const ucontext_t*>(context)->uc_mcontext;
+#if defined __x86_64__
+        const auto pc = static_cast<uintptr_t>(mcontext.gregs[REG_RIP]);
+        auto       fp = static_cast<uintptr_t>(mcontext.gregs[REG_RBP]);
+#else
+        const auto pc = static_cast<uintptr_t>(mcontext.pc);
+        auto       fp = static_cast<uintptr_t>(mcontext.regs[29]);
+#endif
+
+        // Each frame stores the previous frame pointer followed by the return address. Only follow frame pointers that
+        // stay within the stack of the thread and move towards its base, so that corrupt or omitted frame pointers
+        // end the walk instead of causing invalid reads.
+        auto*  frames = state->frames.data() + index * state->maxDepth;
+        size_t depth  = 0;
+
+        frames[depth++] = pc;
+        while (depth < state->maxDepth)
+        {
+            if (fp < state->stackLow || fp > state->stackHigh - 2 * sizeof(uintptr_t) || fp % sizeof(uintptr_t) != 0)
+                break;
+
+            const auto* frame = reinterpret_cast<const uintptr_t*>(fp);
+            if (frame[1] == 0) break;
+            frames[depth++] = frame[1];
+
+            if (frame[0] <= fp) break;
+            fp = frame[0];
+        }
+
+        state->depths[index].store(static_cast<uint32_t>(depth), std::memory_order_release);
+        errno = savedErrno;
+    }
+
+    [[nodiscard]] std::string symbolize(const uintptr_t address)
+    {
+        Dl_info info{};
+        if (dladdr(reinterpret_cast<void*>(address), &info) == 0) return std::format("0x{:x}", address);
+
+        if (info.dli_sname)
+        {
+            auto        status    = 0;
+            char*       demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name(status == 0 && demangled ? demangled : info.dli_sname);
+            std::free(demangled);
+
+            // Semicolons separate frames in the folded format.
+            std::ranges::replace(name, ';', ':');
+            return name;
+        }
+
+        // No symbol, fall back to module and offset.
+        const std::string module = info.dli_fname ? std::filesystem::path(info.dli_fname).filename().string() : "";
+        return std::format("{}+0x{:x}", module, address - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    }
+#endif
+}  // namespace
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    SamplingProfiler::SamplingProfiler(const uint32_t frequency, const size_t capacity, const size_t maxDepth) :
+        state(std::make_unique<State>())
+    {
+        state->frequency = std::max<uint32_t>(frequency, 1);
+        state->capacity  = capacity;
+        state->maxDepth  = std::max<size_t>(maxDepth, 1);
+        state->frames.resize(state->capacity * state->maxDepth);
+        state->depths = std::make_unique<std::atomic<uint32_t>[]>(state->capacity);
+    }
+
+    SamplingProfiler::~SamplingProfiler() noexcept { stop(); }
+
+    bool SamplingProfiler::isAvailable() noexcept
+    {
+#ifdef BETTERTEST_SAMPLING_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t SamplingProfiler::getSampleCount() const noexcept
+    {
+        return std::min(state->next.load(std::memory_order_relaxed), state->capacity);
+    }
+
+    size_t SamplingProfiler::getDroppedCount() const noexcept { return state->dropped.load(std::memory_order_relaxed); }
+
+    ////////////////////////////////////////////////////////////////
+    // Sampling.
+    ////////////////////////////////////////////////////////////////
+
+    bool SamplingProfiler::start()
+    {
+#ifdef BETTERTEST_SAMPLING_PROFILER
+        if (state->running) return true;
+
+        // Determine stack bounds of the calling thread, which the signal handler cannot do itself.
+        pthread_attr_t attr;
+        if (pthread_getattr_np(pthread_self(), &attr) != 0) return false;
+        void*      stack     = nullptr;
+        size_t     stackSize = 0;
+        const auto ok        = pthread_attr_getstack(&attr, &stack, &stackSize) == 0;
+        pthread_attr_destroy(&attr);
+        if (!ok) return false;
+        state->stackLow  = reinterpret_cast<uintptr_t>(stack);
+        state->stackHigh = state->stackLow + stackSize;
+        state->thread    = syscall(SYS_gettid);
+
+        if (State* expected = nullptr;
+            !activeProfiler.compare_exchange_strong(expected, state.get(), std::memory_order_acq_rel))
+            return false;
+
+        struct sigaction action = {};
+        action.sa_sigaction     = handleSignal;
+        action.sa_flags         = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, &state->previousAction) != 0)
+        {
+            activeProfiler.store(nullptr, std::memory_order_release);
+            return false;
+        }
+
+        // Count CPU time of the calling thread only and deliver SIGPROF to that thread, so that samples are neither
+        // triggered by nor delivered to other threads of the process. tv_nsec must stay below one second, so split the
+        // interval.
+        sigevent event               = {};
+        event.sigev_notify           = SIGEV_THREAD_ID;
+        event.sigev_signo            = SIGPROF;
+        event.sigev_notify_thread_id = static_cast<pid_t>(state->thread);
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &state->timer) != 0)
+        {
+            sigaction(SIGPROF, &state->previousAction, nullptr);
+            activeProfiler.store(nullptr, std::memory_order_release);
+            return false;
+        }
+
+        const auto interval = std::max<long>(1'000'000'000 / static_cast<long>(state->frequency), 1);
+        itimerspec timer    = {};
+        timer.it_interval.tv_sec  = static_cast<time_t>(interval / 1'000'000'000);
+        timer.it_interval.tv_nsec = interval % 1'000'000'000;
+        timer.it_value            = timer.it_interval;
+        if (timer_settime(state->timer, 0, &timer, nullptr) != 0)
+        {
+            timer_delete(state->timer);
+            sigaction(SIGPROF, &state->previousAction, nullptr);
+            activeProfiler.store(nullptr, std::memory_order_release);
+            return false;
+        }
+
+        state->running = true;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void SamplingProfiler::stop() noexcept
+    {
+#ifdef BETTERTEST_SAMPLING_PROFILER
+        if (!state || !state->running) return;
+
+        // Delete the timer before restoring the previous handler, so that no signal reaches a default handler.
+        timer_delete(state->timer);
+        activeProfiler.store(nullptr, std::memory_order_release);
+        sigaction(SIGPROF, &state->previousAction, nullptr);
+        state->running = false;
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Output.
+    ////////////////////////////////////////////////////////////////
+
+    void SamplingProfiler::writeFoldedStacks([[maybe_unused]] std::ostream& out) const
+    {
+#ifdef BETTERTEST_SAMPLING_PROFILER
+        std::unordered_map<uintptr_t, std::string> names;
+        std::map<std::string, size_t>              stacks;
+
+        const auto count = getSampleCount();
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto depth = state->depths[i].load(std::memory_order_acquire);
+            if (depth == 0) continue;
+
+            // Frames are stored innermost first. Return addresses point after the call, so look up the call itself.
+            const auto* frames = state->frames.data() + i * state->maxDepth;
+            std::string stack;
+            for (auto d = depth; d-- > 0;)
+            {
+                const auto address = d == 0 ? frames[d] : frames[d] - 1;
+                auto       it      = names.find(address);
+                if (it == names.end()) it = names.emplace(address, symbolize(address)).first;
+
+                if (!stack.empty()) stack += ';';
+                stack += it->second;
+            }
+            stacks[stack]++;
+        }
+
+        for (const auto& [stack, samples] : stacks) out << stack << ' ' << samples << '\n';
+#endif
+    }
+
+    bool SamplingProfiler::writeFoldedStacks(const std::filesystem::path& file) const
+    {
+        std::ofstream out(file);
+        if (!out) return false;
+        writeFoldedStacks(out);
+        return static_cast<bool>(out);
+    }
+}  // namespace bt
@@ -0,0 +1,78 @@
+#include "bettertest/utils/regression.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+namespace bt
+{
+    MannWhitneyResult mannWhitneyU(const std::span<const double> a, const std::span<const double> b)
+    {
+        MannWhitneyResult result;
+        if (a.empty() || b.empty()) return result;
+
+        // Rank the pooled samples, remembering which sample each value came from.
+        std::vector<std::pair<double, bool>> pooled;
+        pooled.reserve(a.size() + b.size());
+        for (const auto x : a) pooled.emplace_back(x, true);
+        for (const auto x : b) pooled.emplace_back(x, false);
+        std::ranges::sort(pooled, {}, &std::pair<double, bool>::first);
+
+        // Sum the ranks of a. Tied values get the average of their ranks.
+        double rankSum = 0;
+        double ties    = 0;
+        for (size_t i = 0; i < pooled.size();)
+        {
+            size_t j = i + 1;
+            while (j < pooled.size() && pooled[j].first == pooled[i].first) j++;
+
+            const auto rank  = static_cast<double>(i + j + 1) / 2;
+            const auto count = static_cast<double>(j - i);
+            for (size_t k = i; k < j; k++)
+                if (pooled[k].second) rankSum += rank;
+            ties += count * count * count - count;
+
+            i = j;
+        }
+
+        const auto n1 = static_cast<double>(a.size());
+        const auto n2 = static_cast<double>(b.size());
+        const auto n  = n1 + n2;
+        result.u      = rankSum - n1 * (n1 + 1) / 2;
+
+        // Normal approximation with tie correction and continuity correction.
+        const auto mean     = n1 * n2 / 2;
+        const auto variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+        if (variance <= 0) return result;
+
+        result.z = (result.u - mean - 0.5) / std::sqrt(variance);
+        result.p = 0.5 * std::erfc(result.z / std::numbers::sqrt2);
+
+        return result;
+    }
+
+    RegressionResult detectRegression(const std::span<const double> samples,
+                                      const std::span<const double> baseline,
+                                      const BenchmarkOptions&       options,
+                                      const bool                    higherIsBetter)
+    {
+        RegressionResult result;
+        if (samples.empty() || baseline.empty()) return result;
+
+        const auto current  = computeStatistics(samples).median;
+        const auto previous = computeStatistics(baseline).median;
+        if (previous > 0) result.shift = higherIsBetter ? 1 - current / previous : current / previous - 1;
+
+        // For rates, test whether the baseline tends to be larger instead.
+        result.p          = higherIsBetter ? mannWhitneyU(baseline, samples).p : mannWhitneyU(samples, baseline).p;
+        result.regression = result.p < options.significance && result.shift > options.regressionThreshold;
+
+        return result;
+    }
+}  // namespace bt
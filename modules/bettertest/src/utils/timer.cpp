@@ -0,0 +1,103 @@
+#include "bettertest/utils/timer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+
+#if (defined __x86_64__ || defined _M_X64) && !(defined _MSC_VER && !defined __clang__)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    /**
+     * \brief Duration over which the cycle counter is calibrated against steady_clock.
+     */
+    constexpr auto calibrationTime = std::chrono::milliseconds(20);
+
+    /**
+     * \brief Returns whether the cycle counter ticks at a constant rate, independent of frequency scaling and sleep
+     * states.
+     */
+    [[nodiscard]] bool hasInvariantCycleCounter() noexcept
+    {
+#if defined __x86_64__ || defined _M_X64
+        // CPUID.80000007H:EDX[8] is the invariant TSC flag.
+#if defined _MSC_VER && !defined __clang__
+        int regs[4] = {};
+        __cpuid(regs, 0x80000000);
+        if (static_cast<unsigned int>(regs[0]) < 0x80000007) return false;
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+#else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+        return (edx & (1u << 8)) != 0;
+#endif
+#elif defined __aarch64__
+        // The generic timer has a fixed frequency by specification.
+        return true;
+#else
+        return false;
+#endif
+    }
+}  // namespace
+
+namespace bt
+{
+    Timer::Timer()
+    {
+        // The steady_clock backend counts in ticks of its own period.
+        ticksPerNs = static_cast<double>(std::chrono::steady_clock::period::den) /
+                     (static_cast<double>(std::chrono::steady_clock::period::num) * 1e9);
+
+        if (hasInvariantCycleCounter())
+        {
+            // Count cycles over a fixed steady_clock interval.
+            const auto clockStart = std::chrono::steady_clock::now();
+            const auto ticksStart = readCycleCounter();
+            auto       clockEnd   = clockStart;
+            while (clockEnd - clockStart < calibrationTime) clockEnd = std::chrono::steady_clock::now();
+            const auto ticksEnd = readCycleCounter();
+
+            const auto ns = std::chrono::duration<double, std::nano>(clockEnd - clockStart).count();
+            if (ticksEnd > ticksStart && ns > 0)
+            {
+                type       = type_t::cycle_counter;
+                ticksPerNs = static_cast<double>(ticksEnd - ticksStart) / ns;
+            }
+        }
+
+        // The overhead is the smallest difference between two consecutive reads.
+        overhead = std::numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < 1000; i++)
+        {
+            const auto start = now();
+            const auto end   = now();
+            overhead         = std::min(overhead, end - start);
+        }
+    }
+
+    const Timer& Timer::get()
+    {
+        static const Timer timer;
+        return timer;
+    }
+
+    std::string_view Timer::getName() const noexcept
+    {
+        switch (type)
+        {
+        case type_t::steady_clock: return "steady_clock";
+#if defined __aarch64__
+        case type_t::cycle_counter: return "cntvct";
+#else
+        case type_t::cycle_counter: return "rdtscp";
+#endif
+        default: return "unknown";
+        }
+    }
+}  // namespace bt
@@ -0,0 +1,155 @@
+#include "bettertest/utils/trace.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <fstream>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /**
+     * \brief Get an identifier of the calling thread that matches the one shown by the OS where possible.
+     */
+    [[nodiscard]] uint64_t getThreadId(const size_t index) noexcept
+    {
+#ifdef __linux__
+        static_cast<void>(index);
+        return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+        return index + 1;
+#endif
+    }
+
+    [[nodiscard]] int64_t getProcessId() noexcept
+    {
+#ifdef _WIN32
+        return _getpid();
+#else
+        return getpid();
+#endif
+    }
+
+    /**
+     * \brief Escape a string for use in a JSON string literal.
+     */
+    [[nodiscard]] std::string escape(const std::string_view s)
+    {
+        std::string escaped;
+        escaped.reserve(s.size());
+        for (const auto c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+                escaped += std::format("\\u{:04x}", static_cast<unsigned>(c));
+            else
+                escaped += c;
+        }
+        return escaped;
+    }
+}  // namespace
+
+namespace bt
+{
+    Tracer::Tracer() : origin(std::chrono::steady_clock::now()), mainThread(std::this_thread::get_id()) {}
+
+    ////////////////////////////////////////////////////////////////
+    // Recording.
+    ////////////////////////////////////////////////////////////////
+
+    uint64_t Tracer::now() const noexcept
+    {
+        return static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+    }
+
+    void Tracer::record(const std::string_view name,
+                        const std::string_view category,
+                        const uint64_t         start,
+                        const uint64_t         end)
+    {
+        getThreadBuffer().spans.emplace_back(std::string(name), category, start, end > start ? end - start : 0);
+    }
+
+    auto Tracer::getThreadBuffer() -> ThreadBuffer&
+    {
+        return buffers.get([this](ThreadBuffer& buffer, const size_t index) {
+            buffer.tid  = getThreadId(index);
+            buffer.main = std::this_thread::get_id() == mainThread;
+        });
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t Tracer::getSpanCount() const
+    {
+        size_t count = 0;
+        buffers.forEach([&](const ThreadBuffer& b) { count += b.spans.size(); });
+        return count;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Writing.
+    ////////////////////////////////////////////////////////////////
+
+    void Tracer::write(std::ostream& out) const
+    {
+        const auto pid       = getProcessId();
+        auto       first     = true;
+        const auto separator = [&] {
+            out << (first ? "\n" : ",\n");
+            first = false;
+        };
+
+        out << R"({"displayTimeUnit":"ns","traceEvents":[)";
+        buffers.forEach([&](const ThreadBuffer& b) {
+            // Name threads, so that the main thread can be told apart from the workers.
+            separator();
+            out << std::format(R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},"args":{{"name":"{}"}}}})",
+                               pid,
+                               b.tid,
+                               b.main ? "main" : "worker");
+
+            // Timestamps are in microseconds.
+            for (const auto& span : b.spans)
+            {
+                separator();
+                out << std::format(R"({{"name":"{}","cat":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{}}})",
+                                   escape(span.name),
+                                   escape(span.category),
+                                   static_cast<double>(span.start) / 1000.0,
+                                   static_cast<double>(span.duration) / 1000.0,
+                                   pid,
+                                   b.tid);
+            }
+        });
+        out << "\n]}\n";
+    }
+
+    bool Tracer::write(const std::filesystem::path& file) const
+    {
+        std::error_code ec;
+        if (file.has_parent_path()) std::filesystem::create_directories(file.parent_path(), ec);
+
+        std::ofstream out(file);
+        if (!out) return false;
+        write(out);
+        return static_cast<bool>(out);
+    }
+}  // namespace bt
@@ -0,0 +1,402 @@
+#include "bettertest/utils/worker_pool.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <climits>
+#include <csignal>
+
+#include <poll.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace
+{
+    /**
+     * \brief Size of a frame header: type (1 byte) and payload size (4 bytes).
+     */
+    constexpr size_t headerSize = 1 + sizeof(uint32_t);
+
+    /**
+     * \brief Largest accepted payload. Guards against allocating memory for a corrupted size.
+     */
+    constexpr uint32_t maxPayloadSize = 1u << 30;
+
+    /**
+     * \brief Appends values to a payload. Both ends run the same executable, so values are written in native byte
+     * order.
+     */
+    class PayloadWriter
+    {
+    public:
+        template<typename T>
+        void write(const T value)
+        {
+            payload.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void write(const std::string_view s)
+        {
+            write(static_cast<uint32_t>(s.size()));
+            payload.append(s);
+        }
+
+        std::string payload;
+    };
+
+    /**
+     * \brief Reads values from a payload. Reading past the end fails instead of reading out of bounds.
+     */
+    class PayloadReader
+    {
+    public:
+        explicit PayloadReader(const std::string_view p) noexcept : payload(p) {}
+
+        template<typename T>
+        [[nodiscard]] bool read(T& value) noexcept
+        {
+            if (payload.size() < sizeof(T)) return false;
+            std::memcpy(&value, payload.data(), sizeof(T));
+            payload.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        [[nodiscard]] bool read(std::string& s)
+        {
+            uint32_t size = 0;
+            if (!read(size) || payload.size() < size) return false;
+            s.assign(payload.substr(0, size));
+            payload.remove_prefix(size);
+            return true;
+        }
+
+        [[nodiscard]] bool done() const noexcept { return payload.empty(); }
+
+    private:
+        std::string_view payload;
+    };
+
+#ifdef __linux__
+    [[nodiscard]] bool writeAll(const int fd, const char* data, size_t size) noexcept
+    {
+        while (size > 0)
+        {
+            // Do not raise SIGPIPE if the other end has exited.
+            const auto n = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool readAll(const int fd, char* data, size_t size) noexcept
+    {
+        while (size > 0)
+        {
+            const auto n = ::recv(fd, data, size, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool makeAddress(const std::filesystem::path& socket, sockaddr_un& address) noexcept
+    {
+        const auto& s = socket.native();
+        if (s.size() >= sizeof(address.sun_path)) return false;
+        address            = {};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, s.c_str(), s.size() + 1);
+        return true;
+    }
+#endif
+}  // namespace
+
+namespace bt
+{
+    ////////////////////////////////////////////////////////////////
+    // WorkerChannel.
+    ////////////////////////////////////////////////////////////////
+
+    WorkerChannel::WorkerChannel(const int socketFd) noexcept : fd(socketFd) {}
+
+    WorkerChannel::WorkerChannel(WorkerChannel&& other) noexcept : fd(std::exchange(other.fd, -1)) {}
+
+    WorkerChannel::~WorkerChannel() noexcept
+    {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    WorkerChannel& WorkerChannel::operator=(WorkerChannel&& other) noexcept
+    {
+        if (this != &other)
+        {
+            WorkerChannel tmp(std::move(*this));
+            fd = std::exchange(other.fd, -1);
+        }
+        return *this;
+    }
+
+    std::optional<WorkerChannel> WorkerChannel::connect(const std::filesystem::path& socket)
+    {
+#ifdef __linux__
+        sockaddr_un address;
+        if (!makeAddress(socket, address)) return std::nullopt;
+
+        WorkerChannel channel(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+        if (channel.fd < 0) return std::nullopt;
+        if (::connect(channel.fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+            return std::nullopt;
+        return channel;
+#else
+        static_cast<void>(socket);
+        return std::nullopt;
+#endif
+    }
+
+    bool WorkerChannel::send(const frame_t type, const std::string_view payload) const
+    {
+#ifdef __linux__
+        // Send header and payload in one write, so that small frames take a single system call.
+        std::string frame;
+        frame.reserve(headerSize + payload.size());
+        frame += static_cast<char>(type);
+        const auto size = static_cast<uint32_t>(payload.size());
+        frame.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        frame.append(payload);
+        return writeAll(fd, frame.data(), frame.size());
+#else
+        static_cast<void>(type);
+        static_cast<void>(payload);
+        return false;
+#endif
+    }
+
+    bool WorkerChannel::receive(frame_t& type, std::string& payload) const
+    {
+#ifdef __linux__
+        char header[headerSize];
+        if (!readAll(fd, header, headerSize)) return false;
+
+        uint32_t size = 0;
+        std::memcpy(&size, header + 1, sizeof(size));
+        if (static_cast<uint8_t>(header[0]) > static_cast<uint8_t>(frame_t::result) || size > maxPayloadSize)
+            return false;
+
+        type = static_cast<frame_t>(header[0]);
+        payload.resize(size);
+        return readAll(fd, payload.data(), size);
+#else
+        static_cast<void>(type);
+        static_cast<void>(payload);
+        return false;
+#endif
+    }
+
+    bool WorkerChannel::wait(const std::chrono::milliseconds timeout) const
+    {
+#ifdef __linux__
+        pollfd     p{.fd = fd, .events = POLLIN, .revents = 0};
+        const auto ms    = static_cast<int>(std::min<int64_t>(timeout.count(), INT_MAX));
+        int        ready = 0;
+        while ((ready = poll(&p, 1, ms)) < 0 && errno == EINTR) {}
+
+        // Errors and a closed connection are reported by the next receive.
+        return ready != 0;
+#else
+        static_cast<void>(timeout);
+        return true;
+#endif
+    }
+
+    std::optional<int64_t> WorkerChannel::getPeerProcess() const
+    {
+#ifdef __linux__
+        ucred     credentials{};
+        socklen_t size = sizeof(credentials);
+        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0) return std::nullopt;
+        return credentials.pid;
+#else
+        return std::nullopt;
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // WorkerListener.
+    ////////////////////////////////////////////////////////////////
+
+    WorkerListener::~WorkerListener() noexcept
+    {
+#ifdef __linux__
+        if (fd < 0) return;
+        close(fd);
+        unlink(socket.c_str());
+#endif
+    }
+
+    bool WorkerListener::listen()
+    {
+#ifdef __linux__
+        static std::atomic<uint32_t> counter = 0;
+
+        std::error_code ec;
+        const auto      dir = std::filesystem::temp_directory_path(ec);
+        if (ec) return false;
+        socket = dir / std::format("bettertest-{}-{}.sock", getpid(), counter.fetch_add(1));
+
+        sockaddr_un address;
+        if (!makeAddress(socket, address)) return false;
+
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return false;
+        unlink(socket.c_str());
+        if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(fd, SOMAXCONN) != 0)
+        {
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::optional<WorkerChannel> WorkerListener::accept(const std::chrono::milliseconds timeout) const
+    {
+#ifdef __linux__
+        pollfd p{.fd = fd, .events = POLLIN, .revents = 0};
+        if (poll(&p, 1, static_cast<int>(timeout.count())) <= 0) return std::nullopt;
+
+        const int client = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) return std::nullopt;
+        return WorkerChannel(client);
+#else
+        static_cast<void>(timeout);
+        return std::nullopt;
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Payloads.
+    ////////////////////////////////////////////////////////////////
+
+    std::string encodeBatch(const std::span<const uint32_t> runners)
+    {
+        PayloadWriter writer;
+        writer.payload.reserve(runners.size() * sizeof(uint32_t));
+        for (const auto r : runners) writer.write(r);
+        return std::move(writer.payload);
+    }
+
+    bool decodeBatch(const std::string_view payload, std::vector<uint32_t>& runners)
+    {
+        if (payload.size() % sizeof(uint32_t) != 0) return false;
+
+        PayloadReader reader(payload);
+        runners.resize(payload.size() / sizeof(uint32_t));
+        for (auto& r : runners) static_cast<void>(reader.read(r));
+        return true;
+    }
+
+    std::string encodeResult(const WorkerResult& result)
+    {
+        PayloadWriter writer;
+        writer.payload.reserve(2 * sizeof(uint32_t) + 2 + sizeof(int64_t) + result.error.size() + result.output.size());
+        writer.write(result.runner);
+        writer.write(static_cast<uint8_t>(result.pass));
+        writer.write(static_cast<uint8_t>(result.failure));
+        writer.write(static_cast<int64_t>(result.duration.count()));
+        writer.write(std::string_view(result.error));
+        writer.write(std::string_view(result.output));
+        return std::move(writer.payload);
+    }
+
+    bool decodeResult(const std::string_view payload, WorkerResult& result)
+    {
+        PayloadReader reader(payload);
+        uint8_t       pass     = 0;
+        uint8_t       failure  = 0;
+        int64_t       duration = 0;
+        if (!reader.read(result.runner) || !reader.read(pass) || !reader.read(failure) || !reader.read(duration) ||
+            !reader.read(result.error) || !reader.read(result.output) || !reader.done())
+            return false;
+
+        result.pass     = pass != 0;
+        result.failure  = static_cast<failure_t>(failure);
+        result.duration = std::chrono::nanoseconds(duration);
+        return true;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Processes.
+    ////////////////////////////////////////////////////////////////
+
+    bool isWorkerPoolSupported() noexcept
+    {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::optional<int64_t> spawnWorker(const std::vector<std::string>& arguments)
+    {
+#ifdef __linux__
+        std::vector<char*> argv;
+        argv.reserve(arguments.size() + 1);
+        for (const auto& a : arguments) argv.emplace_back(const_cast<char*>(a.c_str()));
+        argv.emplace_back(nullptr);
+
+        // Run the current executable, regardless of how it was invoked.
+        pid_t pid = -1;
+        if (posix_spawn(&pid, "/proc/self/exe", nullptr, nullptr, argv.data(), environ) != 0) return std::nullopt;
+        return pid;
+#else
+        static_cast<void>(arguments);
+        return std::nullopt;
+#endif
+    }
+
+    void waitWorker(const int64_t pid) noexcept
+    {
+#ifdef __linux__
+        int status = 0;
+        while (waitpid(static_cast<pid_t>(pid), &status, 0) < 0 && errno == EINTR) {}
+#else
+        static_cast<void>(pid);
+#endif
+    }
+
+    void killWorker(const int64_t pid) noexcept
+    {
+#ifdef __linux__
+        kill(static_cast<pid_t>(pid), SIGKILL);
+#else
+        static_cast<void>(pid);
+#endif
+    }
+}  // namespace bt